@@ -0,0 +1,156 @@
+#include "alloc_tracker.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Счётчики глобальные и атомарные: operator new может вызываться из любого потока
+static std::atomic<std::size_t> g_allocations{0};
+static std::atomic<std::size_t> g_bytes{0};
+static std::atomic<std::size_t> g_live{0};
+static std::atomic<std::size_t> g_peak{0};
+static std::atomic<std::size_t> g_baseline{0};
+
+// Размер блока хранится в заголовке перед указателем, который получает пользователь.
+// Заголовок занимает alignof(max_align_t) байт, чтобы не нарушить выравнивание.
+static constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+static void recordAlloc(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    std::size_t live = g_live.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak = g_peak.load(std::memory_order_relaxed);
+    while (live > peak && !g_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+static void recordFree(std::size_t size) {
+    g_live.fetch_sub(size, std::memory_order_relaxed);
+}
+
+static void* trackedAlloc(std::size_t size, std::size_t align) {
+    if (align < kHeader) align = kHeader;
+    // Заголовок и округление до кратного align не должны переполнить size_t:
+    // иначе malloc выделил бы крошечный блок вместо отказа
+    if (size > SIZE_MAX - 2 * align) return nullptr;
+    std::size_t total = size + align;
+    void* base = nullptr;
+    if (align == kHeader) {
+        base = std::malloc(total);
+    } else {
+        // aligned_alloc требует размер, кратный выравниванию
+        total = (total + align - 1) / align * align;
+        base = std::aligned_alloc(align, total);
+    }
+    if (!base) return nullptr;
+    char* user = static_cast<char*>(base) + align;
+    reinterpret_cast<std::size_t*>(user)[-1] = size;
+    recordAlloc(size);
+    return user;
+}
+
+static void trackedFree(void* p, std::size_t align) {
+    if (!p) return;
+    if (align < kHeader) align = kHeader;
+    char* user = static_cast<char*>(p);
+    recordFree(reinterpret_cast<std::size_t*>(user)[-1]);
+    std::free(user - align);
+}
+
+static void* allocOrThrow(std::size_t size, std::size_t align) {
+    if (size == 0) size = 1;
+    for (;;) {
+        void* p = trackedAlloc(size, align);
+        if (p) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+static void* allocNoThrow(std::size_t size, std::size_t align) noexcept {
+    try {
+        return allocOrThrow(size, align);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new(std::size_t size) { return allocOrThrow(size, kHeader); }
+void* operator new[](std::size_t size) { return allocOrThrow(size, kHeader); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocNoThrow(size, kHeader); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocNoThrow(size, kHeader); }
+
+void* operator new(std::size_t size, std::align_val_t al) {
+    return allocOrThrow(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al) {
+    return allocOrThrow(size, static_cast<std::size_t>(al));
+}
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return allocNoThrow(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return allocNoThrow(size, static_cast<std::size_t>(al));
+}
+
+void operator delete(void* p) noexcept { trackedFree(p, kHeader); }
+void operator delete[](void* p) noexcept { trackedFree(p, kHeader); }
+void operator delete(void* p, std::size_t) noexcept { trackedFree(p, kHeader); }
+void operator delete[](void* p, std::size_t) noexcept { trackedFree(p, kHeader); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { trackedFree(p, kHeader); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { trackedFree(p, kHeader); }
+
+void operator delete(void* p, std::align_val_t al) noexcept {
+    trackedFree(p, static_cast<std::size_t>(al));
+}
+void operator delete[](void* p, std::align_val_t al) noexcept {
+    trackedFree(p, static_cast<std::size_t>(al));
+}
+void operator delete(void* p, std::size_t, std::align_val_t al) noexcept {
+    trackedFree(p, static_cast<std::size_t>(al));
+}
+void operator delete[](void* p, std::size_t, std::align_val_t al) noexcept {
+    trackedFree(p, static_cast<std::size_t>(al));
+}
+void operator delete(void* p, std::align_val_t al, const std::nothrow_t&) noexcept {
+    trackedFree(p, static_cast<std::size_t>(al));
+}
+void operator delete[](void* p, std::align_val_t al, const std::nothrow_t&) noexcept {
+    trackedFree(p, static_cast<std::size_t>(al));
+}
+
+void allocTrackerReset() {
+    std::size_t live = g_live.load(std::memory_order_relaxed);
+    g_allocations.store(0, std::memory_order_relaxed);
+    g_bytes.store(0, std::memory_order_relaxed);
+    g_baseline.store(live, std::memory_order_relaxed);
+    g_peak.store(live, std::memory_order_relaxed);
+}
+
+AllocStats allocTrackerRead() {
+    AllocStats s;
+    std::size_t baseline = g_baseline.load(std::memory_order_relaxed);
+    std::size_t live = g_live.load(std::memory_order_relaxed);
+    std::size_t peak = g_peak.load(std::memory_order_relaxed);
+    s.allocations = g_allocations.load(std::memory_order_relaxed);
+    s.bytes = g_bytes.load(std::memory_order_relaxed);
+    s.peakBytes = peak > baseline ? peak - baseline : 0;
+    s.liveBytes = live > baseline ? live - baseline : 0;
+    return s;
+}
+
+std::string allocCsvHeader() {
+    return "allocs,alloc_bytes,peak_bytes,bytes_per_key";
+}
+
+std::string allocCsvFields(const AllocStats& stats, std::size_t keys) {
+    char buf[128];
+    double perKey = keys ? static_cast<double>(stats.peakBytes) / static_cast<double>(keys) : 0.0;
+    std::snprintf(buf, sizeof(buf), "%zu,%zu,%zu,%.3f", stats.allocations, stats.bytes,
+                  stats.peakBytes, perKey);
+    return buf;
+}
@@ -0,0 +1,48 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Heap instrumentation for the benchmark executables.
+ *
+ * Linking alloc_tracker.cpp into a program replaces the global operator
+ * new/delete (all standard forms, including the aligned and nothrow
+ * ones) with versions that forward to malloc/free and keep count of
+ * allocations, requested bytes and live bytes.  Sizes are the sizes
+ * passed to operator new; malloc's own per-chunk overhead is not
+ * included.  Counters are atomic, so the tracker is safe to use from
+ * several threads.
+ */
+
+struct AllocStats {
+    std::size_t allocations = 0; ///< number of calls to operator new since the reset
+    std::size_t bytes = 0;       ///< total bytes requested since the reset
+    std::size_t peakBytes = 0;   ///< highest live byte count above the level at the reset
+    std::size_t liveBytes = 0;   ///< live bytes above the level at the reset (clamped to 0)
+};
+
+/**
+ * Start a new measurement: zero the counters and remember the current
+ * number of live bytes as the baseline for peakBytes and liveBytes.
+ */
+void allocTrackerReset();
+
+/**
+ * Read the counters accumulated since the last reset.
+ */
+AllocStats allocTrackerRead();
+
+/**
+ * CSV header fragment for the allocation columns, without a leading or
+ * trailing comma.
+ */
+std::string allocCsvHeader();
+
+/**
+ * CSV fields for the given statistics; bytes_per_key is peakBytes / keys.
+ */
+std::string allocCsvFields(const AllocStats& stats, std::size_t keys);
+
+#endif // ALLOC_TRACKER_H
@@ -0,0 +1,352 @@
+#include "bench_common.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+
+#include "../include/two_three_tree.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// Извлекает значение опции вида --name=value; false, если arg не эта опция
+static bool optionValue(const std::string& arg, const std::string& name, std::string& value) {
+    std::string prefix = "--" + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+    value = arg.substr(prefix.size());
+    if (value.empty()) {
+        throw std::runtime_error("Пустое значение опции --" + name);
+    }
+    return true;
+}
+
+static int parseInt(const std::string& s, const std::string& name) {
+    try {
+        std::size_t pos = 0;
+        int v = std::stoi(s, &pos);
+        if (pos != s.size()) throw std::invalid_argument(s);
+        return v;
+    } catch (const std::exception&) {
+        throw std::runtime_error("Некорректное значение опции --" + name + ": " + s);
+    }
+}
+
+static double parseDouble(const std::string& s, const std::string& name) {
+    try {
+        std::size_t pos = 0;
+        double v = std::stod(s, &pos);
+        if (pos != s.size()) throw std::invalid_argument(s);
+        return v;
+    } catch (const std::exception&) {
+        throw std::runtime_error("Некорректное значение опции --" + name + ": " + s);
+    }
+}
+
+bool parseCommonOption(const std::string& arg, BenchOptions& opt) {
+    std::string v;
+    if (optionValue(arg, "alg", v)) {
+        opt.algorithms = splitList(v);
+    } else if (optionValue(arg, "n", v)) {
+        opt.sizes.clear();
+        for (const auto& item : splitList(v)) opt.sizes.push_back(parseSize(item));
+    } else if (optionValue(arg, "dist", v)) {
+        opt.distributions = splitList(v);
+    } else if (optionValue(arg, "seed", v)) {
+        try {
+            opt.seed = std::stoull(v);
+        } catch (const std::exception&) {
+            throw std::runtime_error("Некорректное значение опции --seed: " + v);
+        }
+    } else if (optionValue(arg, "warmup", v)) {
+        opt.warmup = std::max(0, parseInt(v, "warmup"));
+    } else if (optionValue(arg, "reps", v)) {
+        opt.repetitions = std::max(1, parseInt(v, "reps"));
+    } else if (optionValue(arg, "max-reps", v)) {
+        opt.maxRepetitions = std::max(1, parseInt(v, "max-reps"));
+    } else if (optionValue(arg, "min-time-ms", v)) {
+        opt.minTimeMs = std::max(0.0, parseDouble(v, "min-time-ms"));
+    } else if (optionValue(arg, "cpu", v)) {
+        opt.cpu = parseInt(v, "cpu");
+    } else if (optionValue(arg, "out", v)) {
+        opt.output = v;
+    } else if (arg == "--no-verify") {
+        opt.verify = false;
+    } else if (arg == "--perf") {
+        opt.perf = true;
+    } else if (optionValue(arg, "unique", v)) {
+        opt.fewUnique = parseSize(v);
+        // Значения генерируются как int
+        if (opt.fewUnique > static_cast<std::size_t>(INT_MAX)) {
+            throw std::runtime_error("Слишком большое значение опции --unique: " + v);
+        }
+    } else if (optionValue(arg, "swap-pct", v)) {
+        opt.swapPercent = parseDouble(v, "swap-pct");
+        if (!(opt.swapPercent >= 0.0 && opt.swapPercent <= 100.0)) {
+            throw std::runtime_error("--swap-pct должен лежать в интервале [0, 100]");
+        }
+    } else if (optionValue(arg, "zipf-theta", v)) {
+        opt.zipfTheta = parseDouble(v, "zipf-theta");
+        if (!(opt.zipfTheta > 0.0 && opt.zipfTheta < 1.0)) {
+            throw std::runtime_error("--zipf-theta должен лежать в интервале (0, 1)");
+        }
+    } else {
+        return false;
+    }
+    if (opt.maxRepetitions < opt.repetitions) opt.maxRepetitions = opt.repetitions;
+    return true;
+}
+
+std::string commonUsage() {
+    return "  --alg=a,b,...        алгоритмы (по умолчанию все)\n"
+           "  --n=100,1e4,...      размеры входа\n"
+           "  --dist=d1,d2,...     распределения (по умолчанию все)\n"
+           "  --seed=S             базовое зерно генератора (по умолчанию 42)\n"
+           "  --warmup=W           прогревочные запуски (по умолчанию 1)\n"
+           "  --reps=R             минимум замеров на ячейку (по умолчанию 5)\n"
+           "  --max-reps=M         максимум замеров на ячейку (по умолчанию 1000)\n"
+           "  --min-time-ms=T      минимальное суммарное время замеров (по умолчанию 100)\n"
+           "  --cpu=C              привязать процесс к процессору C\n"
+           "  --out=FILE           CSV-файл с результатами\n"
+           "  --no-verify          не проверять корректность результата\n"
+           "  --perf               аппаратные счётчики (perf_event_open) в отдельных запусках\n"
+           "  --zipf-theta=T       перекос распределения Зипфа, 0 < T < 1 (по умолчанию 0.99)\n"
+           "  --unique=K           различных значений в few_unique (по умолчанию 100)\n"
+           "  --swap-pct=P         процент переставленных элементов в nearly_sorted (по умолчанию 1)\n";
+}
+
+bool parseWorkloadOption(const std::string& arg, WorkloadOptions& opt) {
+    std::string v;
+    if (optionValue(arg, "workload", v)) {
+        opt.workloads = splitList(v);
+    } else if (optionValue(arg, "ops", v)) {
+        opt.ops = parseSize(v);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string workloadUsage() {
+    return "  --workload=w1,...    нагрузки (по умолчанию все)\n"
+           "  --ops=N              операций за запуск в нагрузках поиска (по умолчанию 1e6)\n";
+}
+
+std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> items;
+    std::size_t start = 0;
+    while (start <= s.size()) {
+        std::size_t comma = s.find(',', start);
+        if (comma == std::string::npos) comma = s.size();
+        if (comma > start) items.push_back(s.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return items;
+}
+
+std::size_t parseSize(const std::string& s) {
+    double value = 0.0;
+    std::size_t caret = s.find('^');
+    try {
+        std::size_t pos = 0;
+        if (caret != std::string::npos) {
+            double base = std::stod(s.substr(0, caret), &pos);
+            if (pos != caret) throw std::invalid_argument(s);
+            std::string expText = s.substr(caret + 1);
+            double exp = std::stod(expText, &pos);
+            if (pos != expText.size()) throw std::invalid_argument(s);
+            value = std::pow(base, exp);
+        } else {
+            value = std::stod(s, &pos);
+            if (pos != s.size()) throw std::invalid_argument(s);
+        }
+    } catch (const std::exception&) {
+        throw std::runtime_error("Некорректный размер: " + s);
+    }
+    if (!(value >= 1.0) || value != std::floor(value)) {
+        throw std::runtime_error("Размер должен быть целым положительным числом: " + s);
+    }
+    return static_cast<std::size_t>(value);
+}
+
+bool isSelected(const std::vector<std::string>& filter, const std::string& name) {
+    return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+}
+
+void checkFilter(const std::vector<std::string>& filter, const std::vector<std::string>& known,
+                 const std::string& option) {
+    for (const auto& name : filter) {
+        if (std::find(known.begin(), known.end(), name) != known.end()) continue;
+        std::string list;
+        for (const auto& k : known) list += (list.empty() ? "" : ", ") + k;
+        throw std::runtime_error("Неизвестное значение опции " + option + ": " + name + " (допустимо: " + list + ")");
+    }
+}
+
+std::uint64_t cellSeed(std::uint64_t base, std::size_t n, const std::string& dist) {
+    // FNV-1a: в отличие от std::hash результат не зависит от реализации STL
+    std::uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : dist) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    std::seed_seq seq{static_cast<std::uint32_t>(base), static_cast<std::uint32_t>(base >> 32),
+                      static_cast<std::uint32_t>(n), static_cast<std::uint32_t>(n >> 32),
+                      static_cast<std::uint32_t>(h), static_cast<std::uint32_t>(h >> 32)};
+    std::uint32_t out[2];
+    seq.generate(out, out + 2);
+    return (static_cast<std::uint64_t>(out[0]) << 32) | out[1];
+}
+
+const std::vector<std::string>& inputDistributions() {
+    static const std::vector<std::string> names = {"random",     "ascending",  "descending",
+                                                   "few_unique", "nearly_sorted", "organ_pipe",
+                                                   "sawtooth",   "zipf"};
+    return names;
+}
+
+std::vector<int> generateInput(const std::string& dist, std::size_t n, std::uint64_t seed,
+                               const BenchOptions& opt) {
+    std::mt19937_64 gen(seed);
+    std::vector<int> arr;
+    arr.reserve(n);
+
+    if (dist == "random") {
+        // Случайные числа из [1..n] с повторениями
+        std::uniform_int_distribution<int> dis(1, static_cast<int>(n));
+        for (std::size_t i = 0; i < n; ++i) arr.push_back(dis(gen));
+    } else if (dist == "ascending") {
+        for (std::size_t i = 0; i < n; ++i) arr.push_back(static_cast<int>(i + 1));
+    } else if (dist == "descending") {
+        for (std::size_t i = 0; i < n; ++i) arr.push_back(static_cast<int>(n - i));
+    } else if (dist == "few_unique") {
+        std::uniform_int_distribution<int> dis(1, static_cast<int>(opt.fewUnique));
+        for (std::size_t i = 0; i < n; ++i) arr.push_back(dis(gen));
+    } else if (dist == "nearly_sorted") {
+        for (std::size_t i = 0; i < n; ++i) arr.push_back(static_cast<int>(i + 1));
+        // Каждая перестановка затрагивает два элемента
+        std::size_t swaps = static_cast<std::size_t>(static_cast<double>(n) * opt.swapPercent / 200.0);
+        std::uniform_int_distribution<std::size_t> pos(0, n - 1);
+        for (std::size_t s = 0; s < swaps; ++s) std::swap(arr[pos(gen)], arr[pos(gen)]);
+    } else if (dist == "organ_pipe") {
+        for (std::size_t i = 0; i < n; ++i) arr.push_back(static_cast<int>(i < n / 2 ? i + 1 : n - i));
+    } else if (dist == "sawtooth") {
+        std::size_t tooth = std::max<std::size_t>(2, static_cast<std::size_t>(std::sqrt(static_cast<double>(n))));
+        for (std::size_t i = 0; i < n; ++i) arr.push_back(static_cast<int>(i % tooth + 1));
+    } else if (dist == "zipf") {
+        ZipfGenerator zipf(n, opt.zipfTheta);
+        for (std::size_t i = 0; i < n; ++i) arr.push_back(static_cast<int>(zipf(gen) + 1));
+    } else {
+        throw std::runtime_error("Неизвестное распределение: " + dist);
+    }
+    return arr;
+}
+
+ZipfGenerator::ZipfGenerator(std::size_t n, double theta) : n_(n ? n : 1) {
+    zetaN_ = 0.0;
+    for (std::size_t i = 1; i <= n_; ++i) zetaN_ += 1.0 / std::pow(static_cast<double>(i), theta);
+    double zeta2 = 1.0 + std::pow(0.5, theta);
+    half_ = std::pow(0.5, theta);
+    alpha_ = 1.0 / (1.0 - theta);
+    eta_ = (1.0 - std::pow(2.0 / static_cast<double>(n_), 1.0 - theta)) / (1.0 - zeta2 / zetaN_);
+}
+
+static std::uint64_t gcd(std::uint64_t a, std::uint64_t b) {
+    while (b) {
+        std::uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+RankScrambler::RankScrambler(std::size_t n, std::uint64_t seed) : n_(n ? n : 1) {
+    if (n_ > (std::uint64_t{1} << 32)) throw std::runtime_error("RankScrambler: n больше 2^32");
+    std::mt19937_64 gen(seed);
+    mul_ = gen() % n_;
+    if (mul_ == 0) mul_ = 1;
+    while (gcd(mul_, n_) != 1) mul_ = mul_ + 1 < n_ ? mul_ + 1 : 1;
+    add_ = gen() % n_;
+}
+
+bool pinToCpu(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// Перцентиль p (0..1) отсортированной выборки с линейной интерполяцией
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    double pos = p * static_cast<double>(sorted.size() - 1);
+    std::size_t lo = static_cast<std::size_t>(pos);
+    std::size_t hi = std::min(lo + 1, sorted.size() - 1);
+    double frac = pos - static_cast<double>(lo);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+}
+
+std::vector<int> treeKeys(const std::string& dist, std::size_t n, std::uint64_t seed) {
+    std::vector<int> keys(n);
+    for (std::size_t i = 0; i < n; ++i) keys[i] = static_cast<int>(2 * i + 1);
+    if (dist != "sequential") {
+        std::mt19937_64 gen(seed);
+        std::shuffle(keys.begin(), keys.end(), gen);
+    }
+    return keys;
+}
+
+void collect23(const Node23* node, std::vector<int>& out) {
+    if (!node) return;
+    for (std::size_t i = 0; i < node->keys.size(); ++i) {
+        if (!node->isLeaf()) collect23(node->children[i], out);
+        out.push_back(node->keys[i]);
+    }
+    if (!node->isLeaf()) collect23(node->children.back(), out);
+}
+
+RunStats computeStats(std::vector<double> samples) {
+    RunStats s;
+    s.runs = samples.size();
+    if (samples.empty()) return s;
+
+    std::sort(samples.begin(), samples.end());
+    s.min = samples.front();
+    s.median = percentile(samples, 0.5);
+    s.p10 = percentile(samples, 0.1);
+    s.p90 = percentile(samples, 0.9);
+
+    double sum = 0.0;
+    for (double x : samples) sum += x;
+    s.mean = sum / static_cast<double>(samples.size());
+
+    if (samples.size() > 1) {
+        double sq = 0.0;
+        for (double x : samples) sq += (x - s.mean) * (x - s.mean);
+        s.stddev = std::sqrt(sq / static_cast<double>(samples.size() - 1));
+    }
+    return s;
+}
+
+std::string statsCsvHeader() { return "runs,time_ms,median_ms,p10_ms,p90_ms,mean_ms,stddev_ms,min_ms"; }
+
+std::string statsCsvFields(const RunStats& s) {
+    char buf[256];
+    std::snprintf(buf, sizeof(buf), "%zu,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f", s.runs, s.median, s.median, s.p10,
+                  s.p90, s.mean, s.stddev, s.min);
+    return buf;
+}
+
+double throughputMops(std::size_t ops, const RunStats& stats) {
+    // ops / (median_ms * 1000) = миллионов операций в секунду
+    return stats.median > 0.0 ? static_cast<double>(ops) / (stats.median * 1000.0) : 0.0;
+}
@@ -0,0 +1,259 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Node23;
+
+/**
+ * Shared infrastructure for the benchmark executables: command-line
+ * options, deterministic input generation, repeated timing and summary
+ * statistics.  Everything here runs outside the timed region except the
+ * body passed to measureRuns.
+ */
+
+struct BenchOptions {
+    std::vector<std::string> algorithms;    ///< algorithm filter (empty = all)
+    std::vector<std::size_t> sizes;         ///< input sizes to run
+    std::vector<std::string> distributions; ///< distribution filter (empty = all)
+    std::uint64_t seed = 42;                ///< base seed; every cell derives its own from it
+    int warmup = 1;                         ///< untimed runs before measuring
+    int repetitions = 5;                    ///< minimum number of timed runs
+    int maxRepetitions = 1000;              ///< upper bound on timed runs per cell
+    double minTimeMs = 100.0;               ///< keep repeating until this much time is measured
+    int cpu = -1;                           ///< CPU to pin the process to (-1 = no pinning)
+    bool verify = true;                     ///< check the result of every cell
+    bool perf = false;                      ///< collect hardware counters in extra runs
+    double zipfTheta = 0.99;                ///< skew of Zipf-distributed streams, in (0, 1)
+    std::size_t fewUnique = 100;            ///< number of distinct values for "few_unique"
+    double swapPercent = 1.0;               ///< share of elements swapped in "nearly_sorted", in %
+    std::string output;                     ///< path of the CSV file
+};
+
+/**
+ * Options of the benchmarks that run named workloads (tree_bench,
+ * concurrent_bench).
+ */
+struct WorkloadOptions {
+    std::vector<std::string> workloads; ///< workload filter (empty = all)
+    std::size_t ops = 1000000;          ///< operations per run in workloads not sized by n
+};
+
+/**
+ * Summary statistics over the timed runs of one cell, in milliseconds.
+ * Percentiles are linearly interpolated between neighbouring samples.
+ */
+struct RunStats {
+    std::size_t runs = 0;
+    double median = 0.0;
+    double p10 = 0.0;
+    double p90 = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0; ///< sample standard deviation (n - 1 in the denominator)
+    double min = 0.0;
+};
+
+/**
+ * Try to interpret arg as one of the options shared by all benchmarks
+ * (--alg, --n, --dist, --seed, --warmup, --reps, --max-reps,
+ * --min-time-ms, --cpu, --out, --no-verify, --perf, --zipf-theta,
+ * --unique, --swap-pct).
+ * Returns false if arg is not a common option; throws std::runtime_error if its value is
+ * malformed.
+ */
+bool parseCommonOption(const std::string& arg, BenchOptions& opt);
+
+/**
+ * Help text describing the common options, one option per line.
+ */
+std::string commonUsage();
+
+/**
+ * Try to interpret arg as --workload or --ops.  Returns false if arg is
+ * neither; throws std::runtime_error if its value is malformed.
+ */
+bool parseWorkloadOption(const std::string& arg, WorkloadOptions& opt);
+
+/**
+ * Help text describing --workload and --ops.
+ */
+std::string workloadUsage();
+
+/**
+ * Split a comma separated list.  Empty items are dropped.
+ */
+std::vector<std::string> splitList(const std::string& s);
+
+/**
+ * Parse a size such as "1000", "1e6" or "10^5".  Throws
+ * std::runtime_error on malformed input.
+ */
+std::size_t parseSize(const std::string& s);
+
+/**
+ * Return true if name passes the filter.  An empty filter accepts
+ * everything.
+ */
+bool isSelected(const std::vector<std::string>& filter, const std::string& name);
+
+/**
+ * Throw std::runtime_error if the filter given by option (e.g. "--dist")
+ * names something not in known, so that a typo does not silently select
+ * nothing.
+ */
+void checkFilter(const std::vector<std::string>& filter, const std::vector<std::string>& known,
+                 const std::string& option);
+
+/**
+ * Derive the seed of one (n, distribution) cell from the base seed.  The
+ * algorithm is deliberately not part of the seed so that every algorithm
+ * sees exactly the same input.
+ */
+std::uint64_t cellSeed(std::uint64_t base, std::size_t n, const std::string& dist);
+
+/**
+ * Names of the input distributions understood by generateInput.
+ */
+const std::vector<std::string>& inputDistributions();
+
+/**
+ * Generate n integers following the named distribution:
+ *   random        uniform values from [1..n] (with repeats)
+ *   ascending     1, 2, ..., n
+ *   descending    n, n-1, ..., 1
+ *   few_unique    uniform values from [1..opt.fewUnique]
+ *   nearly_sorted ascending with opt.swapPercent % of elements swapped in random pairs
+ *   organ_pipe    ascending to the middle, then descending
+ *   sawtooth      ascending runs of length about sqrt(n)
+ *   zipf          values from [1..n], value v drawn with probability ~ 1 / v^opt.zipfTheta
+ * Throws std::runtime_error for an unknown name.
+ */
+std::vector<int> generateInput(const std::string& dist, std::size_t n, std::uint64_t seed,
+                               const BenchOptions& opt);
+
+/**
+ * n distinct tree keys in insertion order.  The keys are odd (1, 3, 5,
+ * ...), so even numbers are guaranteed to be absent from a tree built
+ * from them.  For "sequential" the keys are ascending, otherwise they are
+ * shuffled.
+ */
+std::vector<int> treeKeys(const std::string& dist, std::size_t n, std::uint64_t seed);
+
+/**
+ * Append the keys of a 2–3 tree to out in ascending order.
+ */
+void collect23(const Node23* node, std::vector<int>& out);
+
+/**
+ * Pin the calling process to a single CPU.  Returns false if pinning is
+ * not supported or failed.
+ */
+bool pinToCpu(int cpu);
+
+/**
+ * Compute summary statistics of the given samples (in milliseconds).
+ */
+RunStats computeStats(std::vector<double> samples);
+
+/**
+ * CSV header of the timing columns:
+ * runs,time_ms,median_ms,p10_ms,p90_ms,mean_ms,stddev_ms,min_ms.
+ * time_ms repeats the median so that older scripts keep working.
+ */
+std::string statsCsvHeader();
+
+/**
+ * Timing columns of one row, matching statsCsvHeader.
+ */
+std::string statsCsvFields(const RunStats& stats);
+
+/**
+ * Throughput in million operations per second at the median run time.
+ */
+double throughputMops(std::size_t ops, const RunStats& stats);
+
+/**
+ * Zipf-distributed ranks in [0, n): rank r is drawn with probability
+ * proportional to 1 / (r + 1)^theta.  Uses the closed-form approximation
+ * of Gray et al. ("Quickly generating billion-record synthetic
+ * databases"), so construction costs O(n) once and every draw is O(1).
+ */
+class ZipfGenerator {
+public:
+    ZipfGenerator(std::size_t n, double theta);
+
+    template <class Gen>
+    std::size_t operator()(Gen& gen) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(gen);
+        double uz = u * zetaN_;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + half_) return n_ > 1 ? 1 : 0;
+        std::size_t r = static_cast<std::size_t>(static_cast<double>(n_) *
+                                                 std::pow(eta_ * u - eta_ + 1.0, alpha_));
+        return r < n_ ? r : n_ - 1;
+    }
+
+private:
+    std::size_t n_;
+    double zetaN_;
+    double half_;  ///< 0.5^theta
+    double alpha_;
+    double eta_;
+};
+
+/**
+ * A bijection on [0, n) used to scatter Zipf ranks so that the hottest
+ * items are not neighbours: i -> (i * m + a) mod n with m coprime to n.
+ * n must not exceed 2^32, so that the product of two residues fits in 64
+ * bits; the constructor throws std::runtime_error otherwise.
+ */
+class RankScrambler {
+public:
+    RankScrambler(std::size_t n, std::uint64_t seed);
+    std::size_t operator()(std::size_t i) const {
+        // m, a < n <= 2^32: (n - 1)^2 + (n - 1) < 2^64
+        return static_cast<std::size_t>(((i % n_) * mul_ + add_) % n_);
+    }
+
+private:
+    std::uint64_t n_;
+    std::uint64_t mul_;
+    std::uint64_t add_;
+};
+
+/**
+ * Run a benchmark cell: opt.warmup untimed runs followed by timed runs
+ * until both opt.repetitions runs and opt.minTimeMs of measured time have
+ * been collected (but never more than opt.maxRepetitions runs).  setup()
+ * is called before every run outside the timed region; only body() is
+ * timed.  Returns the duration of each timed run in milliseconds.
+ */
+template <class Setup, class Body>
+std::vector<double> measureRuns(const BenchOptions& opt, Setup setup, Body body) {
+    for (int i = 0; i < opt.warmup; ++i) {
+        setup();
+        body();
+    }
+
+    std::vector<double> samples;
+    double total = 0.0;
+    while (samples.size() < static_cast<std::size_t>(opt.maxRepetitions) &&
+           (samples.size() < static_cast<std::size_t>(opt.repetitions) || total < opt.minTimeMs)) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        samples.push_back(ms);
+        total += ms;
+    }
+    return samples;
+}
+
+#endif // BENCH_COMMON_H
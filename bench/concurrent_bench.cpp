@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/concurrent_btree.h"
+#include "../include/two_three_tree.h"
+#include "bench_common.h"
+
+// Обёртки над структурами с единым интерфейсом для шаблонного кода бенчмарка;
+// insert и contains вызываются из нескольких потоков одновременно
+
+struct OlcAdapter {
+    static const char* name() { return "btree_olc"; }
+    std::unique_ptr<ConcurrentBTree> tree{new ConcurrentBTree()};
+
+    bool insert(int key) { return tree->insert(key); }
+    bool contains(int key) const { return tree->contains(key); }
+    void clear() { tree.reset(new ConcurrentBTree()); }
+    void collect(std::vector<int>& out) const { tree->collect(out); }
+    bool verify() const { return tree->verify(); }
+};
+
+// Базовая линия: обычное 2-3-дерево под одним глобальным мьютексом
+struct Mutex23Adapter {
+    static const char* name() { return "23_mutex"; }
+    Node23* root = nullptr;
+    mutable std::mutex lock;
+
+    ~Mutex23Adapter() { deleteTree23(root); }
+
+    bool insert(int key) {
+        std::lock_guard<std::mutex> guard(lock);
+        return insert23(root, key);
+    }
+    bool contains(int key) const {
+        std::lock_guard<std::mutex> guard(lock);
+        return contains23(root, key);
+    }
+    void clear() {
+        deleteTree23(root);
+        root = nullptr;
+    }
+
+    void collect(std::vector<int>& out) const { collect23(root, out); }
+    bool verify() const { return true; }
+};
+
+// Порядок вставки ключей: в случайном порядке или по возрастанию
+static const char* const kKeyOrders[] = {"uniform", "sequential"};
+static const char* const kWorkloads[] = {"insert", "lookup"};
+
+// Параметры, специфичные для многопоточного бенчмарка
+struct ConcurrentOptions {
+    WorkloadOptions workload;                    ///< --workload и --ops (число поисков в lookup на все потоки)
+    std::vector<int> threads = {1, 2, 4, 8, 16}; ///< числа потоков, по возрастанию
+    bool stress = false;                         ///< вместо замеров запустить стресс-тест
+    int rounds = 10;                             ///< раундов стресс-теста
+    int readers = 2;                             ///< читающих потоков в стресс-тесте
+};
+
+// Границы части t из threads почти равных частей массива длины n
+static std::size_t sliceBegin(std::size_t n, int threads, int t) {
+    return n * static_cast<std::size_t>(t) / static_cast<std::size_t>(threads);
+}
+
+/**
+ * Потоки, создаваемые один раз на ячейку.  run() будит потоки 1..threads-1,
+ * сам выполняет body(0) и возвращается, когда все закончили.  Создание и
+ * завершение потоков происходят вне замеров.  Ожидающие потоки (и
+ * вызывающий run(), пока дорабатывают остальные) спят на условных
+ * переменных, а не крутятся в цикле, поэтому при threads = nproc не
+ * отнимают процессор у работающих.
+ */
+class WorkerPool {
+public:
+    WorkerPool(int threads, std::function<void(int)> body) : threads_(threads), body_(std::move(body)) {
+        workers_.reserve(static_cast<std::size_t>(threads > 1 ? threads - 1 : 0));
+        for (int t = 1; t < threads; ++t) workers_.emplace_back([this, t] { work(t); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            stop_ = true;
+            ++round_;
+        }
+        start_.notify_all();
+        for (auto& th : workers_) th.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void run() {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            pending_ = threads_ - 1;
+            ++round_;
+        }
+        start_.notify_all();
+        body_(0);
+        std::unique_lock<std::mutex> guard(lock_);
+        finished_.wait(guard, [this] { return pending_ == 0; });
+    }
+
+private:
+    void work(int t) {
+        unsigned seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> guard(lock_);
+                start_.wait(guard, [&] { return round_ != seen; });
+                seen = round_;
+                if (stop_) return;
+            }
+            body_(t);
+            std::lock_guard<std::mutex> guard(lock_);
+            if (--pending_ == 0) finished_.notify_one();
+        }
+    }
+
+    int threads_;
+    std::function<void(int)> body_;
+    std::vector<std::thread> workers_;
+    std::mutex lock_;
+    std::condition_variable start_;    ///< новый запуск или остановка
+    std::condition_variable finished_; ///< все потоки закончили запуск
+    unsigned round_ = 0;
+    int pending_ = 0;
+    bool stop_ = false;
+};
+
+/**
+ * Нагрузка insert: n ключей делятся между потоками поровну, каждый
+ * запуск начинается с пустой структуры.
+ */
+template <class Tree>
+static bool runInsert(const BenchOptions& opt, const std::vector<int>& keys, int threads, RunStats& time) {
+    Tree tree;
+    std::atomic<std::size_t> inserted{0};
+    auto reset = [&] {
+        tree.clear();
+        inserted.store(0);
+    };
+    WorkerPool pool(threads, [&](int t) {
+        std::size_t count = 0;
+        for (std::size_t i = sliceBegin(keys.size(), threads, t); i < sliceBegin(keys.size(), threads, t + 1); ++i)
+            count += tree.insert(keys[i]) ? 1 : 0;
+        inserted.fetch_add(count);
+    });
+
+    time = computeStats(measureRuns(opt, reset, [&] { pool.run(); }));
+    if (!opt.verify) return true;
+
+    std::vector<int> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    std::vector<int> got;
+    got.reserve(keys.size());
+    tree.collect(got);
+    return inserted.load() == keys.size() && got == expected && tree.verify();
+}
+
+/**
+ * Нагрузка lookup: структура строится заранее, потоки делят между собой
+ * поток запросов; каждый второй запрос — промах (чётный ключ).
+ */
+template <class Tree>
+static bool runLookup(const BenchOptions& opt, const ConcurrentOptions& copt, const std::vector<int>& keys,
+                      std::uint64_t seed, int threads, RunStats& time) {
+    Tree tree;
+    for (int k : keys) tree.insert(k);
+
+    std::vector<int> queries(copt.workload.ops);
+    std::mt19937_64 gen(seed + 1);
+    std::uniform_int_distribution<std::size_t> dis(0, keys.size() - 1);
+    for (std::size_t i = 0; i < queries.size(); ++i) queries[i] = static_cast<int>(2 * dis(gen)) + 1 + (i & 1);
+
+    std::atomic<std::size_t> found{0};
+    WorkerPool pool(threads, [&](int t) {
+        std::size_t f = 0;
+        for (std::size_t i = sliceBegin(queries.size(), threads, t); i < sliceBegin(queries.size(), threads, t + 1); ++i)
+            f += tree.contains(queries[i]) ? 1 : 0;
+        found.fetch_add(f);
+    });
+
+    time = computeStats(measureRuns(opt, [&] { found.store(0); }, [&] { pool.run(); }));
+    return !opt.verify || found.load() == (queries.size() + 1) / 2;
+}
+
+template <class Tree>
+static bool runWorkload(const BenchOptions& opt, const ConcurrentOptions& copt, const std::string& workload,
+                        const std::vector<int>& keys, std::uint64_t seed, int threads, RunStats& time) {
+    if (workload == "insert") return runInsert<Tree>(opt, keys, threads, time);
+    if (workload == "lookup") return runLookup<Tree>(opt, copt, keys, seed, threads, time);
+    throw std::runtime_error("Неизвестная нагрузка: " + workload);
+}
+
+/**
+ * Стресс-тест ConcurrentBTree.  В каждом раунде писатели вставляют свои
+ * части ключей в случайном порядке и публикуют, сколько ключей уже
+ * вставлено; читатели одновременно проверяют, что любой опубликованный
+ * ключ находится, а отсутствующий (чётный) — нет.  После раунда
+ * сравниваются итоговое содержимое и инварианты дерева.
+ */
+static bool runStress(const BenchOptions& opt, const ConcurrentOptions& copt, std::size_t n) {
+    int writers = copt.threads.back();
+    for (int round = 0; round < copt.rounds; ++round) {
+        std::uint64_t seed = cellSeed(opt.seed + static_cast<std::uint64_t>(round), n, "stress");
+        std::vector<int> keys = treeKeys("uniform", n, seed);
+
+        ConcurrentBTree tree;
+        std::vector<std::atomic<std::size_t>> published(static_cast<std::size_t>(writers));
+        for (auto& p : published) p.store(0);
+        std::atomic<int> writersLeft{writers};
+        std::atomic<std::size_t> duplicates{0};
+        std::atomic<std::size_t> errors{0};
+        std::atomic<std::size_t> checks{0};
+
+        WorkerPool pool(writers + copt.readers, [&](int t) {
+            if (t < writers) {
+                std::size_t begin = sliceBegin(n, writers, t);
+                std::size_t end = sliceBegin(n, writers, t + 1);
+                for (std::size_t i = begin; i < end; ++i) {
+                    if (!tree.insert(keys[i])) duplicates.fetch_add(1);
+                    published[static_cast<std::size_t>(t)].store(i - begin + 1, std::memory_order_release);
+                }
+                writersLeft.fetch_sub(1);
+                return;
+            }
+            std::mt19937_64 gen(seed + static_cast<std::uint64_t>(t));
+            std::size_t local = 0;
+            while (writersLeft.load() > 0) {
+                int w = static_cast<int>(gen() % static_cast<std::uint64_t>(writers));
+                std::size_t done = published[static_cast<std::size_t>(w)].load(std::memory_order_acquire);
+                if (done == 0) continue;
+                std::size_t i = sliceBegin(n, writers, w) + gen() % done;
+                if (!tree.contains(keys[i])) errors.fetch_add(1);
+                if (tree.contains(keys[i] + 1)) errors.fetch_add(1);
+                ++local;
+            }
+            checks.fetch_add(local);
+        });
+        pool.run();
+
+        std::vector<int> expected = keys;
+        std::sort(expected.begin(), expected.end());
+        std::vector<int> got;
+        got.reserve(n);
+        tree.collect(got);
+        bool ok = duplicates.load() == 0 && errors.load() == 0 && got == expected && tree.verify();
+
+        std::cout << "Раунд " << round + 1 << "/" << copt.rounds << ": писателей=" << writers
+                  << ", читателей=" << copt.readers << ", n=" << n << ", проверок чтения=" << checks.load()
+                  << (ok ? ", ок" : ", ОШИБКА") << "\n";
+        if (!ok) {
+            std::cerr << "Ошибка: ложных дубликатов=" << duplicates.load() << ", неверных поисков="
+                      << errors.load() << ", содержимое " << (got == expected ? "совпадает" : "не совпадает")
+                      << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Общие опции, которые бенчмарк принимает, но не использует: счётчики не
+ * снимаются, а ключи не зависят от распределений sort_bench.  Возвращает
+ * имя опции или пустую строку.
+ */
+static std::string ignoredOption(const std::string& arg) {
+    if (arg == "--perf") return arg;
+    for (const char* name : {"--zipf-theta", "--unique", "--swap-pct"}) {
+        std::string prefix = std::string(name) + "=";
+        if (arg.compare(0, prefix.size(), prefix) == 0) return name;
+    }
+    return "";
+}
+
+static void printUsage(const char* prog) {
+    std::cout << "Использование: " << prog << " [опции]\n"
+              << "Структуры (--alg): btree_olc, 23_mutex\n"
+              << "Распределения ключей (--dist): uniform, sequential\n"
+              << "Нагрузки (--workload): insert, lookup\n\n"
+              << commonUsage() << workloadUsage()
+              << "  --threads=1,2,...    числа потоков (по умолчанию 1,2,4,8,16)\n"
+              << "  --stress             стресс-тест btree_olc вместо замеров\n"
+              << "  --rounds=R           раундов стресс-теста (по умолчанию 10)\n"
+              << "  --readers=K          читающих потоков в стресс-тесте (по умолчанию 2)\n"
+              << "Опции --cpu, --perf, --zipf-theta, --unique и --swap-pct игнорируются.\n";
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    opt.sizes = {100000, 1000000};
+    opt.output = "concurrent_results.csv";
+    ConcurrentOptions copt;
+    std::vector<std::string> ignored;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            }
+            if (arg.compare(0, 10, "--threads=") == 0) {
+                copt.threads.clear();
+                for (const auto& item : splitList(arg.substr(10))) {
+                    std::size_t t = parseSize(item);
+                    if (t < 1 || t > 1024) throw std::runtime_error("Некорректное число потоков: " + item);
+                    copt.threads.push_back(static_cast<int>(t));
+                }
+                if (copt.threads.empty()) throw std::runtime_error("Пустой список потоков");
+                std::sort(copt.threads.begin(), copt.threads.end());
+                copt.threads.erase(std::unique(copt.threads.begin(), copt.threads.end()), copt.threads.end());
+            } else if (arg == "--stress") {
+                copt.stress = true;
+            } else if (arg.compare(0, 9, "--rounds=") == 0) {
+                copt.rounds = static_cast<int>(std::max<std::size_t>(1, parseSize(arg.substr(9))));
+            } else if (arg.compare(0, 10, "--readers=") == 0) {
+                copt.readers = static_cast<int>(std::min<std::size_t>(1024, parseSize(arg.substr(10))));
+            } else if (!ignoredOption(arg).empty()) {
+                ignored.push_back(ignoredOption(arg));
+            } else if (!parseWorkloadOption(arg, copt.workload) && !parseCommonOption(arg, opt)) {
+                throw std::runtime_error("Неизвестная опция: " + arg);
+            }
+        }
+        checkFilter(opt.algorithms, {OlcAdapter::name(), Mutex23Adapter::name()}, "--alg");
+        checkFilter(opt.distributions, {std::begin(kKeyOrders), std::end(kKeyOrders)}, "--dist");
+        checkFilter(copt.workload.workloads, {std::begin(kWorkloads), std::end(kWorkloads)}, "--workload");
+        for (std::size_t n : opt.sizes) {
+            if (n == 0) throw std::runtime_error("Размер должен быть положительным");
+            if (n > 1000000000) throw std::runtime_error("Слишком большой размер: ключи должны помещаться в int");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (opt.cpu >= 0) {
+        std::cerr << "Предупреждение: --cpu игнорируется, потоки должны работать на разных процессорах\n";
+    }
+    for (const auto& name : ignored) {
+        std::cerr << "Предупреждение: " << name << " игнорируется, этот бенчмарк её не использует\n";
+    }
+    if (static_cast<unsigned>(copt.threads.back()) > std::thread::hardware_concurrency()) {
+        std::cerr << "Предупреждение: потоков больше, чем процессоров (" << std::thread::hardware_concurrency()
+                  << "), масштабирование на них не измеряется\n";
+    }
+
+    if (copt.stress) {
+        for (std::size_t n : opt.sizes) {
+            if (!runStress(opt, copt, n)) return 2;
+        }
+        std::cout << "\nСтресс-тест пройден\n";
+        return 0;
+    }
+
+    std::ofstream fout(opt.output);
+    if (!fout) {
+        std::cerr << "Ошибка: не удалось открыть " << opt.output << " для записи.\n";
+        return 1;
+    }
+    fout << "algorithm,workload,n,distribution,threads,ops," << statsCsvHeader() << ",mops,speedup\n";
+    fout << std::fixed << std::setprecision(6);
+
+    for (std::size_t n : opt.sizes) {
+        for (const char* dist : kKeyOrders) {
+            if (!isSelected(opt.distributions, dist)) continue;
+            std::uint64_t seed = cellSeed(opt.seed, n, dist);
+            const std::vector<int> keys = treeKeys(dist, n, seed);
+
+            for (const char* workload : kWorkloads) {
+                if (!isSelected(copt.workload.workloads, workload)) continue;
+                std::size_t ops = std::string(workload) == "insert" ? n : copt.workload.ops;
+
+                for (const char* structure : {OlcAdapter::name(), Mutex23Adapter::name()}) {
+                    if (!isSelected(opt.algorithms, structure)) continue;
+
+                    // Ускорение считается относительно наименьшего числа потоков
+                    double baseMops = 0.0;
+                    for (int threads : copt.threads) {
+                        RunStats s;
+                        bool ok;
+                        if (structure == OlcAdapter::name())
+                            ok = runWorkload<OlcAdapter>(opt, copt, workload, keys, seed, threads, s);
+                        else
+                            ok = runWorkload<Mutex23Adapter>(opt, copt, workload, keys, seed, threads, s);
+                        if (!ok) {
+                            std::cerr << "Ошибка: " << structure << " дал неверный результат, нагрузка="
+                                      << workload << ", n=" << n << ", тип=" << dist << ", потоков=" << threads
+                                      << "\n";
+                            return 2;
+                        }
+
+                        double mops = throughputMops(ops, s);
+                        if (baseMops == 0.0) baseMops = mops;
+                        double speedup = baseMops > 0.0 ? mops / baseMops : 0.0;
+                        fout << structure << "," << workload << "," << n << "," << dist << "," << threads << ","
+                             << ops << "," << statsCsvFields(s) << "," << mops << "," << speedup << "\n";
+
+                        std::cout << "Готово: " << structure << ", " << workload << ", n=" << n << ", тип=" << dist
+                                  << ", потоков=" << threads << ", медиана=" << std::setprecision(3) << s.median
+                                  << " мс, " << mops << " Mops/s, ускорение=" << std::setprecision(2) << speedup
+                                  << std::defaultfloat << "\n";
+                    }
+                }
+            }
+        }
+    }
+
+    fout.close();
+    if (!fout) {
+        std::cerr << "Ошибка записи в " << opt.output << "\n";
+        return 1;
+    }
+    std::cout << "\nРезультаты записаны в файл " << opt.output << "\n";
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include "perf_counters.h"
+
+#include <cstdint>
+#include <cstdio>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+#ifdef __linux__
+// Формат чтения лидера группы: nr, time_enabled, time_running, затем значения всех членов
+static const std::uint64_t kGroupFormat =
+    PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+// Формат отдельного счётчика: value, time_enabled, time_running
+static const std::uint64_t kSingleFormat = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+// У glibc нет обёртки для perf_event_open.  Члены группы (groupFd >= 0)
+// создаются включёнными и считают, пока включён лидер.
+static int openEvent(std::uint32_t type, std::uint64_t config, int groupFd, std::uint64_t readFormat) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = readFormat;
+    long fd = syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+    return static_cast<int>(fd);
+}
+
+static std::uint64_t cacheConfig(std::uint64_t cache, std::uint64_t result) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+}
+#endif
+
+PerfCounters::PerfCounters() {
+    for (int& fd : fds_) fd = -1;
+    for (int& slot : groupSlot_) slot = -1;
+#ifdef __linux__
+    // Лидер группы — такты; остальные события по возможности входят в его
+    // группу и потому включены на PMU ровно тогда же, когда и такты
+    fds_[kPerfCycles] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1, kGroupFormat);
+    int leader = fds_[kPerfCycles];
+    int members = 0;
+    if (leader >= 0) groupSlot_[kPerfCycles] = members++;
+
+    // Событие, которое не помещается в группу (PMU не может считать все
+    // события сразу), открывается отдельно и масштабируется само по себе
+    auto open = [&](PerfEvent event, std::uint32_t type, std::uint64_t config) {
+        if (leader >= 0) {
+            int fd = openEvent(type, config, leader, kGroupFormat);
+            if (fd >= 0) {
+                groupSlot_[event] = members++;
+                return fd;
+            }
+        }
+        return openEvent(type, config, -1, kSingleFormat);
+    };
+    fds_[kPerfInstructions] = open(kPerfInstructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds_[kPerfL1dMisses] = open(kPerfL1dMisses, PERF_TYPE_HW_CACHE,
+                                cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS));
+    fds_[kPerfLlcMisses] = open(kPerfLlcMisses, PERF_TYPE_HW_CACHE,
+                                cacheConfig(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS));
+    // Не все процессоры умеют LL-события; обобщённый cache-misses тоже считает промахи LLC
+    if (fds_[kPerfLlcMisses] < 0) {
+        fds_[kPerfLlcMisses] = open(kPerfLlcMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    }
+    fds_[kPerfBranchMisses] = open(kPerfBranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    fds_[kPerfDtlbMisses] = open(kPerfDtlbMisses, PERF_TYPE_HW_CACHE,
+                                 cacheConfig(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_RESULT_MISS));
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds_) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+#ifdef __linux__
+// Применить ioctl к лидеру (вместе со всей группой) и к отдельным счётчикам
+static void controlAll(const int* fds, const int* groupSlot, unsigned long request) {
+    for (int i = 0; i < kPerfEventCount; ++i) {
+        if (fds[i] < 0) continue;
+        if (i == kPerfCycles && groupSlot[i] >= 0) {
+            ioctl(fds[i], request, PERF_IOC_FLAG_GROUP);
+        } else if (groupSlot[i] < 0) {
+            ioctl(fds[i], request, 0);
+        }
+    }
+}
+#endif
+
+void PerfCounters::reset() {
+#ifdef __linux__
+    controlAll(fds_, groupSlot_, PERF_EVENT_IOC_RESET);
+#endif
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+    controlAll(fds_, groupSlot_, PERF_EVENT_IOC_ENABLE);
+#endif
+}
+
+void PerfCounters::stop() {
+#ifdef __linux__
+    controlAll(fds_, groupSlot_, PERF_EVENT_IOC_DISABLE);
+#endif
+}
+
+PerfSample PerfCounters::read() const {
+    PerfSample sample;
+#ifdef __linux__
+    // Группа: все её события масштабируются одним и тем же коэффициентом
+    if (fds_[kPerfCycles] >= 0 && groupSlot_[kPerfCycles] >= 0) {
+        std::uint64_t buf[3 + kPerfEventCount] = {};
+        ssize_t got = ::read(fds_[kPerfCycles], buf, sizeof(buf));
+        // Группа ни разу не попала на PMU — значения неизвестны
+        if (got >= static_cast<ssize_t>(3 * sizeof(std::uint64_t)) && buf[2] != 0) {
+            double scale = static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+            for (int i = 0; i < kPerfEventCount; ++i) {
+                int slot = groupSlot_[i];
+                if (fds_[i] < 0 || slot < 0 || static_cast<std::uint64_t>(slot) >= buf[0]) continue;
+                sample.valid[i] = true;
+                sample.value[i] = static_cast<double>(buf[3 + slot]) * scale;
+            }
+        }
+    }
+    for (int i = 0; i < kPerfEventCount; ++i) {
+        if (fds_[i] < 0 || groupSlot_[i] >= 0) continue;
+        // value, time_enabled, time_running
+        std::uint64_t buf[3] = {0, 0, 0};
+        if (::read(fds_[i], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) continue;
+        // Счётчик ни разу не попал на PMU — значение неизвестно
+        if (buf[2] == 0) continue;
+        double scale = static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+        sample.valid[i] = true;
+        sample.value[i] = static_cast<double>(buf[0]) * scale;
+    }
+#endif
+    return sample;
+}
+
+const char* perfEventName(PerfEvent event) {
+    switch (event) {
+    case kPerfCycles: return "cycles";
+    case kPerfInstructions: return "instructions";
+    case kPerfL1dMisses: return "l1d_misses";
+    case kPerfLlcMisses: return "llc_misses";
+    case kPerfBranchMisses: return "branch_misses";
+    case kPerfDtlbMisses: return "dtlb_misses";
+    default: return "unknown";
+    }
+}
+
+std::string perfCsvHeader() {
+    std::string header;
+    for (int i = 0; i < kPerfEventCount; ++i) {
+        if (i > 0) header += ",";
+        header += perfEventName(static_cast<PerfEvent>(i));
+    }
+    return header;
+}
+
+std::string perfCsvFields(const PerfSample& sample, std::size_t runs) {
+    std::string fields;
+    for (int i = 0; i < kPerfEventCount; ++i) {
+        if (i > 0) fields += ",";
+        if (!sample.valid[i] || runs == 0) continue;
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.0f", sample.value[i] / static_cast<double>(runs));
+        fields += buf;
+    }
+    return fields;
+}
@@ -0,0 +1,102 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Hardware performance counters read through Linux perf_event_open.
+ *
+ * Counters belong to the calling thread and count user space only.  The
+ * cycle counter leads an event group and every other event joins it when
+ * the PMU can count them all at once, so grouped events are always
+ * scheduled (and scaled under multiplexing) together and ratios such as
+ * IPC stay consistent.  An event that does not fit into the group is
+ * opened on its own.  Events the kernel or the CPU does not
+ * provide are simply left closed: the benchmark keeps running and the
+ * corresponding values are reported as unavailable.  On other platforms
+ * no counter is ever available.
+ */
+
+enum PerfEvent {
+    kPerfCycles,
+    kPerfInstructions,
+    kPerfL1dMisses,
+    kPerfLlcMisses,
+    kPerfBranchMisses,
+    kPerfDtlbMisses,
+    kPerfEventCount
+};
+
+/**
+ * Counter values accumulated between reset() and read().  Values are
+ * scaled by time_enabled / time_running when the kernel had to multiplex
+ * counters.
+ */
+struct PerfSample {
+    bool valid[kPerfEventCount] = {};
+    double value[kPerfEventCount] = {};
+};
+
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /// true if at least one counter could be opened
+    bool available() const;
+
+    /// zero all counters
+    void reset();
+
+    /// start counting (counts accumulate across start/stop pairs)
+    void start();
+
+    /// stop counting
+    void stop();
+
+    /// read the accumulated values
+    PerfSample read() const;
+
+private:
+    int fds_[kPerfEventCount];
+    int groupSlot_[kPerfEventCount]; ///< position in the cycles group, or -1 if opened separately
+};
+
+/**
+ * Run setup() and body() the given number of times, counting only while
+ * body() executes.  Returns the totals over all runs.
+ */
+template <class Setup, class Body>
+PerfSample countRuns(PerfCounters& counters, int runs, Setup setup, Body body) {
+    counters.reset();
+    for (int i = 0; i < runs; ++i) {
+        setup();
+        counters.start();
+        body();
+        counters.stop();
+    }
+    return counters.read();
+}
+
+/**
+ * Column name used for the event in CSV output, e.g. "l1d_misses".
+ */
+const char* perfEventName(PerfEvent event);
+
+/**
+ * CSV header fragment listing every event column, separated by commas
+ * and without a leading or trailing comma.
+ */
+std::string perfCsvHeader();
+
+/**
+ * CSV fields for the sample divided by runs (values per run).  Unavailable
+ * counters produce empty fields so the column layout never changes.
+ */
+std::string perfCsvFields(const PerfSample& sample, std::size_t runs);
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/sort_algorithms.h"
+#include "alloc_tracker.h"
+#include "bench_common.h"
+#include "perf_counters.h"
+
+// Описание алгоритма сортировки для бенчмарка
+struct SortAlgorithm {
+    const char* name;
+    void (*run)(std::vector<int>& arr);
+    const char* quadraticOn; ///< распределение, на котором алгоритм работает за O(n²), или nullptr
+};
+
+static void runMerge(std::vector<int>& arr) { mergeSort(arr, 0, arr.size() - 1); }
+static void runQuick(std::vector<int>& arr) { quickSort(arr, 0, arr.size() - 1); }
+static void runQuick3(std::vector<int>& arr) { quickSort3Way(arr, 0, arr.size() - 1); }
+static void runHeap(std::vector<int>& arr) { heapSort(arr); }
+
+static const SortAlgorithm kAlgorithms[] = {
+    {"merge", runMerge, nullptr},
+    // Опорный элемент — средний, поэтому «органная труба» даёт худший случай
+    {"quick", runQuick, "organ_pipe"},
+    {"quick3", runQuick3, nullptr},
+    {"heap", runHeap, nullptr},
+};
+
+// Имя явно указано в фильтре (пустой фильтр выбирает всё, но не явно)
+static bool isExplicit(const std::vector<std::string>& filter, const std::string& name) {
+    return !filter.empty() && isSelected(filter, name);
+}
+
+/**
+ * Квадратичные ячейки (при n = 10⁶ один запуск идёт минуты) исключены из
+ * полного прогона и запускаются, только если и алгоритм, и распределение
+ * указаны явно в --alg и --dist.
+ */
+static bool isOptInCell(const BenchOptions& opt, const SortAlgorithm& alg, const std::string& dist) {
+    return alg.quadraticOn && dist == alg.quadraticOn &&
+           !(isExplicit(opt.algorithms, alg.name) && isExplicit(opt.distributions, dist));
+}
+
+static void printUsage(const char* prog) {
+    std::cout << "Использование: " << prog << " [опции]\n"
+              << "Алгоритмы: merge, quick, quick3, heap\n"
+              << "Распределения: random, ascending, descending, few_unique, nearly_sorted,\n"
+              << "               organ_pipe, sawtooth, zipf\n"
+              << "quick на organ_pipe работает за O(n^2) и запускается, только если оба указаны явно\n\n"
+              << commonUsage();
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    opt.sizes = {100, 1000, 10000, 100000, 1000000};
+    opt.output = "results.csv";
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            }
+            if (!parseCommonOption(arg, opt)) {
+                throw std::runtime_error("Неизвестная опция: " + arg);
+            }
+        }
+        std::vector<std::string> algorithms;
+        for (const auto& alg : kAlgorithms) algorithms.push_back(alg.name);
+        checkFilter(opt.algorithms, algorithms, "--alg");
+        checkFilter(opt.distributions, inputDistributions(), "--dist");
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (opt.cpu >= 0 && !pinToCpu(opt.cpu)) {
+        std::cerr << "Предупреждение: не удалось привязать процесс к CPU " << opt.cpu << "\n";
+    }
+
+    PerfCounters counters;
+    if (opt.perf && !counters.available()) {
+        std::cerr << "Предупреждение: аппаратные счётчики недоступны, столбцы останутся пустыми\n";
+    }
+
+    std::ofstream fout(opt.output);
+    if (!fout) {
+        std::cerr << "Ошибка: не удалось открыть " << opt.output << " для записи.\n";
+        return 1;
+    }
+    fout << "algorithm,n,distribution," << statsCsvHeader() << "," << perfCsvHeader() << ","
+         << allocCsvHeader() << "\n";
+
+    for (std::size_t n : opt.sizes) {
+        for (const auto& dist : inputDistributions()) {
+            if (!isSelected(opt.distributions, dist)) continue;
+
+            const std::vector<int> input = generateInput(dist, n, cellSeed(opt.seed, n, dist), opt);
+            std::vector<int> expected;
+            if (opt.verify) {
+                expected = input;
+                std::sort(expected.begin(), expected.end());
+            }
+
+            for (const auto& alg : kAlgorithms) {
+                if (!isSelected(opt.algorithms, alg.name)) continue;
+                if (isOptInCell(opt, alg, dist)) {
+                    std::cout << "Пропуск: " << alg.name << ", n=" << n << ", тип=" << dist
+                              << " (квадратичный случай; укажите --alg=" << alg.name << " --dist=" << dist
+                              << ")\n";
+                    continue;
+                }
+
+                std::vector<int> work;
+                std::vector<double> samples = measureRuns(
+                    opt, [&] { work = input; }, [&] { alg.run(work); });
+
+                // Проверка результата последнего запуска (вне замера)
+                if (opt.verify && work != expected) {
+                    std::cerr << "Ошибка: " << alg.name << " неверно отсортировал n=" << n
+                              << ", тип=" << dist << "\n";
+                    return 2;
+                }
+
+                // Счётчики снимаются в отдельных запусках, чтобы ioctl не попадал в замер времени
+                PerfSample perf;
+                int perfRuns = 0;
+                if (opt.perf && counters.available()) {
+                    perfRuns = opt.repetitions;
+                    perf = countRuns(counters, perfRuns, [&] { work = input; }, [&] { alg.run(work); });
+                }
+
+                // Память: отдельный запуск; копия входа переиспользует ёмкость work и не выделяет памяти
+                work = input;
+                allocTrackerReset();
+                alg.run(work);
+                AllocStats mem = allocTrackerRead();
+
+                RunStats s = computeStats(samples);
+                fout << alg.name << "," << n << "," << dist << "," << statsCsvFields(s) << ","
+                     << perfCsvFields(perf, static_cast<std::size_t>(perfRuns)) << ","
+                     << allocCsvFields(mem, n) << "\n";
+
+                std::cout << "Готово: " << alg.name << ", n=" << n << ", тип=" << dist
+                          << ", медиана=" << std::setprecision(3) << s.median << " мс"
+                          << " (p10=" << s.p10 << ", p90=" << s.p90 << ", запусков=" << s.runs
+                          << ")\n";
+            }
+        }
+    }
+
+    fout.close();
+    if (!fout) {
+        std::cerr << "Ошибка записи в " << opt.output << "\n";
+        return 1;
+    }
+    std::cout << "\nРезультаты записаны в файл " << opt.output << "\n";
+    return 0;
+}
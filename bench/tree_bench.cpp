@@ -0,0 +1,561 @@
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/avl_tree.h"
+#include "../include/eytzinger_layout.h"
+#include "../include/two_three_tree.h"
+#include "alloc_tracker.h"
+#include "bench_common.h"
+#include "perf_counters.h"
+
+// Обёртки над деревьями с единым интерфейсом для шаблонного кода бенчмарка
+
+struct AVLAdapter {
+    static const char* name() { return "avl"; }
+    AVLNode* root = nullptr;
+
+    void build(const std::vector<int>& keys) {
+        for (int k : keys) insert(k);
+    }
+    void insert(int key) { root = avlInsert(root, key); }
+    bool contains(int key) const { return avlContains(root, key); }
+    void lookupBatch(const int* keys, std::size_t n, bool* found) const { avlLookupBatch(root, keys, n, found); }
+    void clear() {
+        deleteTree(root);
+        root = nullptr;
+    }
+
+    static void collect(const AVLNode* node, std::vector<int>& out) {
+        if (!node) return;
+        collect(node->left, out);
+        out.push_back(node->key);
+        collect(node->right, out);
+    }
+    void collect(std::vector<int>& out) const { collect(root, out); }
+};
+
+struct Tree23Adapter {
+    static const char* name() { return "23"; }
+    Node23* root = nullptr;
+
+    void build(const std::vector<int>& keys) {
+        for (int k : keys) insert(k);
+    }
+    void insert(int key) { insert23(root, key); }
+    bool contains(int key) const { return contains23(root, key); }
+    void lookupBatch(const int* keys, std::size_t n, bool* found) const { lookupBatch23(root, keys, n, found); }
+    void clear() {
+        deleteTree23(root);
+        root = nullptr;
+    }
+
+    void collect(std::vector<int>& out) const { collect23(root, out); }
+};
+
+// Статическая раскладка Эйтцингера, «замороженная» из AVL-дерева; вставки не поддерживает
+struct EytzingerAdapter {
+    static const char* name() { return "eytzinger"; }
+    EytzingerLayout layout;
+
+    void build(const std::vector<int>& keys) {
+        AVLAdapter avl;
+        avl.build(keys);
+        layout = freezeAVL(avl.root);
+        avl.clear();
+    }
+    bool contains(int key) const { return eytzingerContains(layout, key); }
+    void clear() { layout = EytzingerLayout(); }
+
+    // Обход неявного дерева (дети узла k — 2k и 2k+1) в порядке возрастания
+    void collect(std::size_t k, std::vector<int>& out) const {
+        if (k > layout.size()) return;
+        collect(2 * k, out);
+        out.push_back(layout.keys[k]);
+        collect(2 * k + 1, out);
+    }
+    void collect(std::vector<int>& out) const { collect(1, out); }
+};
+
+static const std::vector<std::string>& structures() {
+    static const std::vector<std::string> names = {AVLAdapter::name(), Tree23Adapter::name(),
+                                                   EytzingerAdapter::name()};
+    return names;
+}
+
+static const std::vector<std::string>& keyDistributions() {
+    static const std::vector<std::string> names = {"uniform", "sequential", "zipf"};
+    return names;
+}
+
+static const std::vector<std::string>& workloads() {
+    static const std::vector<std::string> names = {"build",     "lookup_hit", "lookup_miss",
+                                                   "batch_hit", "batch_miss", "mixed"};
+    return names;
+}
+
+// Параметры, специфичные для бенчмарка деревьев
+struct TreeOptions {
+    WorkloadOptions workload;   ///< --workload и --ops (число операций в нагрузках поиска и mixed)
+    double writeRatio = 0.1;    ///< доля вставок в нагрузке mixed
+    std::size_t batch = 4096;   ///< размер пакета в нагрузках batch_hit / batch_miss
+};
+
+/**
+ * Поток индексов ключей из [0, n): uniform — равномерно случайные,
+ * sequential — по возрастанию (с повтором по кругу), zipf — по закону
+ * Зипфа, причём самые частые индексы разбросаны по всему диапазону.
+ */
+static std::vector<std::size_t> indexStream(const std::string& dist, std::size_t n, std::size_t count,
+                                            std::uint64_t seed, double theta) {
+    std::vector<std::size_t> idx(count);
+    std::mt19937_64 gen(seed);
+    if (dist == "uniform") {
+        std::uniform_int_distribution<std::size_t> dis(0, n - 1);
+        for (auto& i : idx) i = dis(gen);
+    } else if (dist == "sequential") {
+        for (std::size_t i = 0; i < count; ++i) idx[i] = i % n;
+    } else if (dist == "zipf") {
+        ZipfGenerator zipf(n, theta);
+        RankScrambler scramble(n, seed);
+        for (auto& i : idx) i = scramble(zipf(gen));
+    } else {
+        throw std::runtime_error("Неизвестное распределение ключей: " + dist);
+    }
+    return idx;
+}
+
+/**
+ * Поток вставок для нагрузки build: для uniform и sequential это n
+ * различных ключей, для zipf — n ключей с повторами по закону Зипфа.
+ */
+static std::vector<int> buildStream(const std::string& dist, std::size_t n, std::uint64_t seed, double theta) {
+    if (dist != "zipf") return treeKeys(dist, n, seed);
+    std::vector<int> keys;
+    keys.reserve(n);
+    for (std::size_t i : indexStream(dist, n, n, seed, theta)) keys.push_back(static_cast<int>(2 * i + 1));
+    return keys;
+}
+
+// Отсортированные различные значения
+static std::vector<int> sortedUnique(std::vector<int> v) {
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+    return v;
+}
+
+// Операция нагрузки mixed
+struct MixedOp {
+    int key;
+    bool write;
+};
+
+// Результат одной ячейки (структура, нагрузка, n, распределение)
+struct CellResult {
+    std::size_t ops = 0;
+    std::size_t keys = 0; ///< сколько ключей добавлено в структуру (для bytes_per_key)
+    RunStats time;
+    PerfSample perf;
+    int perfRuns = 0;
+    AllocStats mem;
+};
+
+struct TreeBenchContext {
+    const BenchOptions& opt;
+    const TreeOptions& tree;
+    PerfCounters& counters;
+};
+
+// Не даёт компилятору выбросить результат поиска
+static volatile std::size_t g_sink = 0;
+
+template <class Tree, class Setup, class Body>
+static void measureCell(const TreeBenchContext& ctx, Setup setup, Body body, CellResult& res) {
+    res.time = computeStats(measureRuns(ctx.opt, setup, body));
+    if (ctx.opt.perf && ctx.counters.available()) {
+        res.perfRuns = ctx.opt.repetitions;
+        res.perf = countRuns(ctx.counters, res.perfRuns, setup, body);
+    }
+    // Память: отдельный запуск после подготовки
+    setup();
+    allocTrackerReset();
+    body();
+    res.mem = allocTrackerRead();
+}
+
+template <class Tree>
+static bool runBuild(const TreeBenchContext& ctx, const std::vector<int>& stream, CellResult& res) {
+    Tree tree;
+    auto build = [&] {
+        for (int k : stream) tree.insert(k);
+    };
+    auto reset = [&] { tree.clear(); };
+
+    std::vector<int> expected = sortedUnique(stream);
+    res.ops = stream.size();
+    res.keys = expected.size();
+    // После measureCell дерево построено запуском, в котором считалась память
+    measureCell<Tree>(ctx, reset, build, res);
+
+    bool ok = true;
+    if (ctx.opt.verify) {
+        std::vector<int> got;
+        got.reserve(expected.size());
+        tree.collect(got);
+        ok = got == expected;
+    }
+    tree.clear();
+    return ok;
+}
+
+/**
+ * Сверить eytzingerLowerBound с std::lower_bound по отсортированным ключам:
+ * запросы — сами ключи, числа на единицу меньше (промахи между ключами) и
+ * границы диапазона.  На больших n проверяется равномерная выборка ключей.
+ */
+static bool lowerBoundMatches(const EytzingerLayout& layout, const std::vector<int>& sorted) {
+    auto check = [&](int q) {
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), q);
+        int got = 0;
+        bool found = eytzingerLowerBound(layout, q, got);
+        return found == (it != sorted.end()) && (!found || got == *it);
+    };
+    if (!check(INT_MIN) || !check(INT_MAX)) return false;
+    std::size_t step = std::max<std::size_t>(1, sorted.size() / 100000);
+    for (std::size_t i = 0; i < sorted.size(); i += step) {
+        if (!check(sorted[i]) || !check(sorted[i] - 1) || !check(sorted[i] + 1)) return false;
+    }
+    return true;
+}
+
+/**
+ * Нагрузка build для статической раскладки: AVL-дерево строится заранее,
+ * замеряется только заморозка.  При проверке раскладка сравнивается с
+ * заморозкой 2-3-дерева из того же потока и с построением из
+ * отсортированных ключей, а lower_bound — с std::lower_bound.
+ */
+static bool runFreeze(const TreeBenchContext& ctx, const std::vector<int>& stream, CellResult& res) {
+    AVLAdapter avl;
+    avl.build(stream);
+    EytzingerAdapter frozen;
+    auto freeze = [&] { frozen.layout = freezeAVL(avl.root); };
+    auto reset = [&] { frozen.clear(); };
+
+    std::vector<int> expected = sortedUnique(stream);
+    res.ops = expected.size();
+    res.keys = expected.size();
+    measureCell<EytzingerAdapter>(ctx, reset, freeze, res);
+    avl.clear();
+
+    bool ok = true;
+    if (ctx.opt.verify) {
+        std::vector<int> got;
+        got.reserve(expected.size());
+        frozen.collect(got);
+        Tree23Adapter t23;
+        t23.build(stream);
+        EytzingerLayout from23 = freeze23(t23.root);
+        t23.clear();
+        ok = got == expected && from23.keys == frozen.layout.keys &&
+             buildEytzinger(expected).keys == frozen.layout.keys && lowerBoundMatches(frozen.layout, expected);
+    }
+    return ok;
+}
+
+template <class Tree>
+static bool runLookup(const TreeBenchContext& ctx, const std::vector<int>& keys,
+                      const std::vector<int>& queries, bool hits, CellResult& res) {
+    Tree tree;
+    tree.build(keys);
+
+    std::size_t found = 0;
+    auto lookup = [&] {
+        std::size_t f = 0;
+        for (int q : queries) f += tree.contains(q) ? 1 : 0;
+        found = f;
+        g_sink = g_sink + f;
+    };
+
+    res.ops = queries.size();
+    measureCell<Tree>(ctx, [] {}, lookup, res);
+    tree.clear();
+    return !ctx.opt.verify || found == (hits ? queries.size() : 0);
+}
+
+// Тот же поток запросов, что и в lookup_*, но пакетами через lookupBatch
+template <class Tree>
+static bool runBatch(const TreeBenchContext& ctx, const std::vector<int>& keys,
+                     const std::vector<int>& queries, bool hits, CellResult& res) {
+    Tree tree;
+    tree.build(keys);
+
+    std::size_t batch = std::min(ctx.tree.batch, queries.size());
+    std::unique_ptr<bool[]> found(new bool[batch]);
+    std::size_t foundCount = 0;
+    auto lookup = [&] {
+        std::size_t f = 0;
+        for (std::size_t start = 0; start < queries.size(); start += batch) {
+            std::size_t len = std::min(batch, queries.size() - start);
+            tree.lookupBatch(queries.data() + start, len, found.get());
+            for (std::size_t i = 0; i < len; ++i) f += found[i] ? 1 : 0;
+        }
+        foundCount = f;
+        g_sink = g_sink + f;
+    };
+
+    res.ops = queries.size();
+    measureCell<Tree>(ctx, [] {}, lookup, res);
+    tree.clear();
+    return !ctx.opt.verify || foundCount == (hits ? queries.size() : 0);
+}
+
+template <class Tree>
+static bool runMixed(const TreeBenchContext& ctx, const std::vector<int>& keys,
+                     const std::vector<MixedOp>& ops, CellResult& res) {
+    Tree tree;
+    // Каждый запуск начинается с одного и того же дерева
+    auto rebuild = [&] {
+        tree.clear();
+        tree.build(keys);
+    };
+
+    std::size_t found = 0;
+    auto mixed = [&] {
+        std::size_t f = 0;
+        for (const MixedOp& op : ops) {
+            if (op.write)
+                tree.insert(op.key);
+            else
+                f += tree.contains(op.key) ? 1 : 0;
+        }
+        found = f;
+        g_sink = g_sink + f;
+    };
+
+    std::vector<int> all = keys;
+    std::size_t reads = 0;
+    for (const MixedOp& op : ops) {
+        if (op.write)
+            all.push_back(op.key);
+        else
+            ++reads;
+    }
+    std::vector<int> expected = sortedUnique(all);
+
+    res.ops = ops.size();
+    res.keys = expected.size() - keys.size();
+    measureCell<Tree>(ctx, rebuild, mixed, res);
+
+    bool ok = true;
+    if (ctx.opt.verify) {
+        std::vector<int> got;
+        got.reserve(expected.size());
+        tree.collect(got);
+        ok = got == expected && found == reads;
+    }
+    tree.clear();
+    return ok;
+}
+
+// Входные данные одной ячейки; общие для всех структур
+struct CellInput {
+    std::vector<int> stream;      ///< build: поток вставок
+    std::vector<int> keys;        ///< поиск и mixed: ключи исходного дерева
+    std::vector<int> queries;     ///< lookup_* / batch_*: поток запросов
+    std::vector<MixedOp> mixed;   ///< mixed: поток операций
+};
+
+static CellInput makeInput(const BenchOptions& opt, const TreeOptions& topt, const std::string& workload,
+                           const std::string& dist, std::size_t n) {
+    std::uint64_t seed = cellSeed(opt.seed, n, dist);
+    CellInput in;
+    if (workload == "build") {
+        in.stream = buildStream(dist, n, seed, opt.zipfTheta);
+        return in;
+    }
+
+    in.keys = treeKeys(dist, n, seed);
+    // Запросы используют другое зерно, чем порядок вставки
+    std::vector<std::size_t> idx = indexStream(dist, n, topt.workload.ops, seed + 1, opt.zipfTheta);
+    if (workload == "lookup_hit" || workload == "lookup_miss" || workload == "batch_hit" ||
+        workload == "batch_miss") {
+        // Нечётные ключи есть в дереве, чётные — нет
+        bool hits = workload == "lookup_hit" || workload == "batch_hit";
+        int offset = hits ? 1 : 2;
+        in.queries.reserve(idx.size());
+        for (std::size_t i : idx) in.queries.push_back(static_cast<int>(2 * i) + offset);
+    } else if (workload == "mixed") {
+        std::mt19937_64 gen(seed + 2);
+        std::bernoulli_distribution isWrite(topt.writeRatio);
+        in.mixed.reserve(idx.size());
+        for (std::size_t i : idx) {
+            bool write = isWrite(gen);
+            // Вставляются новые (чётные) ключи, читаются существующие
+            in.mixed.push_back({static_cast<int>(2 * i) + (write ? 2 : 1), write});
+        }
+    } else {
+        throw std::runtime_error("Неизвестная нагрузка: " + workload);
+    }
+    return in;
+}
+
+// Статические структуры не поддерживают вставки, поэтому mixed для них не запускается;
+// пакетный поиск есть только у деревьев
+static bool supportsWorkload(const std::string& structure, const std::string& workload) {
+    if (structure != EytzingerAdapter::name()) return true;
+    return workload != "mixed" && workload != "batch_hit" && workload != "batch_miss";
+}
+
+template <class Tree>
+static bool runWorkload(const TreeBenchContext& ctx, const std::string& workload,
+                        const CellInput& in, CellResult& res) {
+    if (workload == "build") return runBuild<Tree>(ctx, in.stream, res);
+    if (workload == "lookup_hit") return runLookup<Tree>(ctx, in.keys, in.queries, true, res);
+    if (workload == "lookup_miss") return runLookup<Tree>(ctx, in.keys, in.queries, false, res);
+    if (workload == "batch_hit") return runBatch<Tree>(ctx, in.keys, in.queries, true, res);
+    if (workload == "batch_miss") return runBatch<Tree>(ctx, in.keys, in.queries, false, res);
+    if (workload == "mixed") return runMixed<Tree>(ctx, in.keys, in.mixed, res);
+    throw std::runtime_error("Неизвестная нагрузка: " + workload);
+}
+
+template <>
+bool runWorkload<EytzingerAdapter>(const TreeBenchContext& ctx, const std::string& workload,
+                                   const CellInput& in, CellResult& res) {
+    if (workload == "build") return runFreeze(ctx, in.stream, res);
+    if (workload == "lookup_hit") return runLookup<EytzingerAdapter>(ctx, in.keys, in.queries, true, res);
+    if (workload == "lookup_miss") return runLookup<EytzingerAdapter>(ctx, in.keys, in.queries, false, res);
+    throw std::runtime_error("Нагрузка не поддерживается статической структурой: " + workload);
+}
+
+static void printUsage(const char* prog) {
+    std::cout << "Использование: " << prog << " [опции]\n"
+              << "Структуры (--alg): avl, 23, eytzinger\n"
+              << "Распределения ключей (--dist): uniform, sequential, zipf\n"
+              << "Нагрузки (--workload): build, lookup_hit, lookup_miss, batch_hit, batch_miss, mixed\n\n"
+              << commonUsage() << workloadUsage()
+              << "  --write-ratio=W      доля вставок в mixed, 0..1 (по умолчанию 0.1)\n"
+              << "  --batch=B            размер пакета в batch_* (по умолчанию 4096)\n";
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    opt.sizes = {1000, 10000, 100000, 1000000};
+    opt.output = "tree_results.csv";
+    TreeOptions topt;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            }
+            if (arg.compare(0, 8, "--batch=") == 0) {
+                topt.batch = parseSize(arg.substr(8));
+            } else if (arg.compare(0, 14, "--write-ratio=") == 0) {
+                std::string v = arg.substr(14);
+                std::size_t pos = 0;
+                try {
+                    topt.writeRatio = std::stod(v, &pos);
+                } catch (const std::exception&) {
+                    pos = 0;
+                }
+                if (pos == 0 || pos != v.size() || !(topt.writeRatio >= 0.0 && topt.writeRatio <= 1.0)) {
+                    throw std::runtime_error("Некорректное значение опции --write-ratio: " + v);
+                }
+            } else if (!parseWorkloadOption(arg, topt.workload) && !parseCommonOption(arg, opt)) {
+                throw std::runtime_error("Неизвестная опция: " + arg);
+            }
+        }
+        checkFilter(opt.algorithms, structures(), "--alg");
+        checkFilter(opt.distributions, keyDistributions(), "--dist");
+        checkFilter(topt.workload.workloads, workloads(), "--workload");
+        for (std::size_t n : opt.sizes) {
+            if (n > 1000000000) throw std::runtime_error("Слишком большой размер: ключи должны помещаться в int");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (opt.cpu >= 0 && !pinToCpu(opt.cpu)) {
+        std::cerr << "Предупреждение: не удалось привязать процесс к CPU " << opt.cpu << "\n";
+    }
+
+    PerfCounters counters;
+    if (opt.perf && !counters.available()) {
+        std::cerr << "Предупреждение: аппаратные счётчики недоступны, столбцы останутся пустыми\n";
+    }
+    TreeBenchContext ctx{opt, topt, counters};
+
+    std::ofstream fout(opt.output);
+    if (!fout) {
+        std::cerr << "Ошибка: не удалось открыть " << opt.output << " для записи.\n";
+        return 1;
+    }
+    fout << "algorithm,workload,n,distribution,ops," << statsCsvHeader() << ",mops," << perfCsvHeader() << ","
+         << allocCsvHeader() << "\n";
+    fout << std::fixed << std::setprecision(6);
+
+    for (std::size_t n : opt.sizes) {
+        for (const auto& dist : keyDistributions()) {
+            if (!isSelected(opt.distributions, dist)) continue;
+
+            for (const auto& workload : workloads()) {
+                if (!isSelected(topt.workload.workloads, workload)) continue;
+                const CellInput input = makeInput(opt, topt, workload, dist, n);
+
+                for (const auto& structure : structures()) {
+                    if (!isSelected(opt.algorithms, structure) || !supportsWorkload(structure, workload)) continue;
+
+                    CellResult res;
+                    bool ok;
+                    if (structure == AVLAdapter::name())
+                        ok = runWorkload<AVLAdapter>(ctx, workload, input, res);
+                    else if (structure == Tree23Adapter::name())
+                        ok = runWorkload<Tree23Adapter>(ctx, workload, input, res);
+                    else
+                        ok = runWorkload<EytzingerAdapter>(ctx, workload, input, res);
+                    if (!ok) {
+                        std::cerr << "Ошибка: " << structure << " дал неверный результат, нагрузка="
+                                  << workload << ", n=" << n << ", тип=" << dist << "\n";
+                        return 2;
+                    }
+
+                    const RunStats& s = res.time;
+                    double mops = throughputMops(res.ops, s);
+                    fout << structure << "," << workload << "," << n << "," << dist << "," << res.ops << ","
+                         << statsCsvFields(s) << "," << mops << ","
+                         << perfCsvFields(res.perf, static_cast<std::size_t>(res.perfRuns))
+                         << "," << allocCsvFields(res.mem, res.keys) << "\n";
+
+                    std::cout << "Готово: " << structure << ", " << workload << ", n=" << n
+                              << ", тип=" << dist << ", медиана=" << std::setprecision(3) << s.median
+                              << " мс, " << mops << " Mops/s";
+                    if (res.keys > 0) {
+                        std::cout << ", " << std::setprecision(1) << std::fixed
+                                  << static_cast<double>(res.mem.peakBytes) / static_cast<double>(res.keys)
+                                  << " байт/ключ" << std::defaultfloat;
+                    }
+                    std::cout << "\n";
+                }
+            }
+        }
+    }
+
+    fout.close();
+    if (!fout) {
+        std::cerr << "Ошибка записи в " << opt.output << "\n";
+        return 1;
+    }
+    std::cout << "\nРезультаты записаны в файл " << opt.output << "\n";
+    return 0;
+}
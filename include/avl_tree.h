@@ -1,6 +1,8 @@
 #ifndef AVL_TREE_H
 #define AVL_TREE_H
 
+#include <cstddef>
+
 /**
  * A simple implementation of an AVL tree for integer keys.
  *
@@ -55,6 +57,21 @@ AVLNode* rotateLeft(AVLNode* x);
  */
 AVLNode* avlInsert(AVLNode* node, int key);
 
+/**
+ * Return true if the key is stored in the AVL tree rooted at the given
+ * node.  The search walks a single root‑to‑leaf path iteratively.
+ */
+bool avlContains(const AVLNode* root, int key);
+
+/**
+ * Look up n keys at once: found[i] is set to whether keys[i] is stored in
+ * the tree.  Up to 16 searches advance in an interleaved fashion, one
+ * level per step each, and every step prefetches the next node of its
+ * search, so for trees larger than the cache many misses are in flight
+ * at the same time instead of one.
+ */
+void avlLookupBatch(const AVLNode* root, const int* keys, std::size_t n, bool* found);
+
 /**
  * Perform an inorder traversal of the AVL tree printing the keys to
  * standard output.  Keys are separated by spaces.
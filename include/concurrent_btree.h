@@ -0,0 +1,71 @@
+#ifndef CONCURRENT_BTREE_H
+#define CONCURRENT_BTREE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * A B+‑tree of integer keys that supports concurrent insert and lookup
+ * from any number of threads using optimistic lock coupling (Leis et al.,
+ * "The ART of Practical Synchronization").
+ *
+ * Like the 2–3 tree it is balanced by splitting full nodes, but nodes are
+ * much wider (one node spans a few cache lines) and every node carries a
+ * version lock: a 64‑bit word whose bit 1 means "locked" and whose other
+ * bits count modifications.  Readers never write shared memory; they
+ * remember the version of each node they pass, read optimistically, and
+ * restart from the root if a version changed underneath them.  Writers
+ * descend the same way and lock only the node they modify (and its parent
+ * when the node has to be split).  Full nodes are split eagerly on the
+ * way down, so a split never has to propagate further up.
+ *
+ * Nodes are never freed while the tree is alive (there is no deletion),
+ * so an optimistic reader can always safely dereference a pointer it has
+ * validated.
+ */
+class ConcurrentBTree {
+public:
+    ConcurrentBTree();
+    ~ConcurrentBTree();
+
+    ConcurrentBTree(const ConcurrentBTree&) = delete;
+    ConcurrentBTree& operator=(const ConcurrentBTree&) = delete;
+
+    /**
+     * Insert a key.  Returns false if the key was already present.  Safe
+     * to call concurrently with insert and contains.
+     */
+    bool insert(int key);
+
+    /**
+     * Return true if the key is stored in the tree.  Safe to call
+     * concurrently with insert and contains.
+     */
+    bool contains(int key) const;
+
+    /**
+     * Append all keys in ascending order to out.  Not thread‑safe: call
+     * only when no other thread modifies the tree.
+     */
+    void collect(std::vector<int>& out) const;
+
+    /**
+     * Check the structural invariants (sorted keys, separators bounding
+     * their subtrees, all leaves at the same depth).  Not thread‑safe.
+     */
+    bool verify() const;
+
+    static constexpr int kLeafCapacity = 60;  ///< keys per leaf (a leaf is 256 bytes)
+    static constexpr int kInnerCapacity = 19; ///< keys per inner node (20 children)
+
+private:
+    struct Node;
+    struct Leaf;
+    struct Inner;
+
+    std::atomic<Node*> root_;
+};
+
+#endif // CONCURRENT_BTREE_H
@@ -0,0 +1,87 @@
+#ifndef EYTZINGER_LAYOUT_H
+#define EYTZINGER_LAYOUT_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "avl_tree.h"
+#include "two_three_tree.h"
+
+/**
+ * An immutable search structure produced by "freezing" an AVL tree or a
+ * 2–3 tree.  The keys are stored in a single array in Eytzinger (BFS)
+ * order: the root is at index 1 and the children of the node at index k
+ * are at 2k and 2k + 1.  There are no pointers, so the structure costs
+ * 4 bytes per key, and a search only computes the next index, which lets
+ * it run without branches and prefetch the nodes four levels below.
+ *
+ * The array is aligned to a cache line, so the 16 descendants four levels
+ * below any node always share one 64‑byte line.
+ */
+
+/**
+ * Minimal allocator returning memory aligned to Align bytes.
+ */
+template <class T, std::size_t Align>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <class U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+    void deallocate(T* p, std::size_t) { ::operator delete(p, std::align_val_t(Align)); }
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+    template <class U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+struct EytzingerLayout {
+    /// keys[1..n] in BFS order; keys[0] is unused so that the root is at index 1
+    std::vector<int, AlignedAllocator<int, 64>> keys;
+
+    /// number of keys stored
+    std::size_t size() const { return keys.empty() ? 0 : keys.size() - 1; }
+};
+
+/**
+ * Build the layout from keys sorted in ascending order.
+ */
+EytzingerLayout buildEytzinger(const std::vector<int>& sortedKeys);
+
+/**
+ * Freeze an AVL tree: copy its keys into a new layout.  The tree is not
+ * modified and may be deleted afterwards.
+ */
+EytzingerLayout freezeAVL(const AVLNode* root);
+
+/**
+ * Freeze a 2–3 tree: copy its keys into a new layout.  The tree is not
+ * modified and may be deleted afterwards.
+ */
+EytzingerLayout freeze23(const Node23* root);
+
+/**
+ * Return true if the key is stored in the layout.
+ */
+bool eytzingerContains(const EytzingerLayout& layout, int key);
+
+/**
+ * Find the smallest stored key that is not less than key.  Returns false
+ * if every stored key is less than key; otherwise stores the found key in
+ * result and returns true.
+ */
+bool eytzingerLowerBound(const EytzingerLayout& layout, int key, int& result);
+
+#endif // EYTZINGER_LAYOUT_H
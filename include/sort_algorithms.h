@@ -18,6 +18,11 @@ void mergeSort(std::vector<int>& arr, std::size_t l, std::size_t r);
 // Quick sort: sorts arr[l..r] in ascending order
 void quickSort(std::vector<int>& arr, std::size_t l, std::size_t r);
 
+// Quick sort with three-way partitioning: sorts arr[l..r] in ascending
+// order; keys equal to the pivot are excluded from further recursion, so
+// inputs with few distinct values take O(n log k) for k distinct keys
+void quickSort3Way(std::vector<int>& arr, std::size_t l, std::size_t r);
+
 // Heap sort: sorts entire array in ascending order
 void heapSort(std::vector<int>& arr);
 
@@ -1,6 +1,7 @@
 #ifndef TWO_THREE_TREE_H
 #define TWO_THREE_TREE_H
 
+#include <cstddef>
 #include <vector>
 
 /**
@@ -27,12 +28,28 @@ struct Node23 {
 
 /**
  * Insert a key into the 2–3 tree.  On return the root pointer may
- * change due to splits at the root.
+ * change due to splits at the root.  Duplicate keys are not inserted.
  *
  * @param root reference to the root pointer of the tree
  * @param key  the key to insert
+ * @return true if the key was inserted, false if it was already present
  */
-void insert23(Node23*& root, int key);
+bool insert23(Node23*& root, int key);
+
+/**
+ * Return true if the key is stored in the 2–3 tree rooted at node.
+ */
+bool contains23(const Node23* node, int key);
+
+/**
+ * Look up n keys at once: found[i] is set to whether keys[i] is stored in
+ * the tree.  Up to 16 searches are interleaved.  Visiting a node takes
+ * two steps, because its keys and children live in separate vector
+ * buffers: the first step prefetches both buffers, the second compares
+ * the keys and prefetches the chosen child.  Meanwhile the other searches
+ * make progress, so many cache misses overlap.
+ */
+void lookupBatch23(const Node23* root, const int* keys, std::size_t n, bool* found);
 
 /**
  * Perform an inorder traversal printing the keys to standard output.
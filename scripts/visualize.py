@@ -4,18 +4,39 @@ visualize.py
 ---------------
 
 This script reads sorting performance data from ``results.csv`` and
-produces simple line plots comparing merge sort, quick sort and heap
-sort on different input distributions.  The results file is expected
+produces simple line plots comparing merge sort, quick sort (two-way
+and three-way) and heap sort on different input distributions.  The results file is expected
 to have columns ``algorithm``, ``n``, ``distribution`` and
-``time_ms``.  For each distribution (random, ascending, descending)
-the script generates a separate PNG image showing running time
-versus input size for the three algorithms.
+``time_ms`` (the median over repeated runs, as written by
+``sort_bench``).  For each distribution (random, ascending, descending,
+few_unique, nearly_sorted, organ_pipe, sawtooth, zipf) the script
+generates a separate PNG image showing running time versus input size
+for every algorithm.
+
+If the file also contains hardware counter columns (``cycles``,
+``instructions``, ``l1d_misses``, ...; see ``sort_bench --perf``) the
+script additionally plots derived metrics: instructions per cycle and
+misses per element.  Empty counter fields (counters unavailable) are
+skipped.  Allocation columns (``bytes_per_key``, written by both
+``sort_bench`` and ``tree_bench``) are plotted as memory per key.
+
+Files written by ``tree_bench`` carry an extra ``workload`` column;
+their rows are grouped by workload and key distribution, throughput
+(``mops``, million operations per second) is plotted instead of time,
+and counter metrics are divided by the number of operations instead of
+``n``.
+
+Files written by ``concurrent_bench`` also have a ``threads`` column;
+for them throughput is plotted against the number of threads, one
+image per workload, key distribution and ``n``.
 
 Usage:
-    python visualize.py [path/to/results.csv]
+    python visualize.py [path/to/results.csv ...]
 
-If no argument is provided the script looks for ``results.csv`` in
-the current working directory.  Output images are saved in the same
+Several files may be given, e.g. ``results.csv tree_results.csv
+concurrent_results.csv``; the plots are then written side by side.  If no argument is
+provided the script looks for ``results.csv`` in the current working
+directory.  Output images are saved in the same
 directory as the input file.
 """
 
@@ -26,10 +47,25 @@ from collections import defaultdict
 import matplotlib.pyplot as plt
 
 
-def load_results(csv_path):
+def _group(row):
+    """Plot group of a row: the distribution, prefixed by the workload if any."""
+    workload = row.get('workload')
+    if workload:
+        return f"{workload}_{row['distribution']}"
+    return row['distribution']
+
+
+def _elements(row):
+    """Number of elements (or operations) a row's counters refer to."""
+    ops = row.get('ops')
+    return int(ops) if ops else int(row['n'])
+
+
+def load_results(csv_path, column='time_ms'):
     """Load results from a CSV file into a nested dictionary.
 
-    Returns a mapping of distribution -> algorithm -> list of (n, time_ms).
+    Returns a mapping of distribution -> algorithm -> list of (n, value)
+    where value is taken from the given column (``time_ms`` by default).
     """
     data = defaultdict(lambda: defaultdict(list))
     with open(csv_path, newline='', encoding='utf-8') as f:
@@ -37,8 +73,8 @@ def load_results(csv_path):
         for row in reader:
             alg = row['algorithm']
             n = int(row['n'])
-            dist = row['distribution']
-            time_ms = float(row['time_ms'])
+            dist = _group(row)
+            time_ms = float(row[column])
             data[dist][alg].append((n, time_ms))
     # Sort each list by n to ensure lines connect in order
     for dist in data:
@@ -47,6 +83,189 @@ def load_results(csv_path):
     return data
 
 
+# Hardware counter columns written by the benchmarks
+MISS_COLUMNS = ['l1d_misses', 'llc_misses', 'branch_misses', 'dtlb_misses']
+
+
+def _number(row, column):
+    """Return row[column] as float, or None if it is missing or empty."""
+    value = row.get(column)
+    if value is None or value == '':
+        return None
+    return float(value)
+
+
+def load_counters(csv_path):
+    """Load derived counter metrics from a CSV file.
+
+    Returns a mapping of metric -> distribution -> algorithm -> list of
+    (n, value).  Metrics are ``ipc`` and ``<column>_per_elem`` for each
+    miss column.  Rows without counter values are skipped.
+    """
+    metrics = defaultdict(lambda: defaultdict(lambda: defaultdict(list)))
+    with open(csv_path, newline='', encoding='utf-8') as f:
+        reader = csv.DictReader(f)
+        for row in reader:
+            alg = row['algorithm']
+            n = int(row['n'])
+            dist = _group(row)
+            elements = _elements(row)
+            cycles = _number(row, 'cycles')
+            instructions = _number(row, 'instructions')
+            if cycles and instructions is not None:
+                metrics['ipc'][dist][alg].append((n, instructions / cycles))
+            for column in MISS_COLUMNS:
+                misses = _number(row, column)
+                if misses is not None:
+                    metrics[f'{column}_per_elem'][dist][alg].append((n, misses / elements))
+    for metric in metrics.values():
+        for alg_data in metric.values():
+            for points in alg_data.values():
+                points.sort(key=lambda x: x[0])
+    return metrics
+
+
+def plot_counters(metrics, output_dir):
+    """Plot derived counter metrics for each distribution."""
+    labels = {
+        'ipc': 'Инструкций за такт (IPC)',
+        'l1d_misses_per_elem': 'Промахов L1d на элемент',
+        'llc_misses_per_elem': 'Промахов LLC на элемент',
+        'branch_misses_per_elem': 'Ошибок предсказания переходов на элемент',
+        'dtlb_misses_per_elem': 'Промахов dTLB на элемент',
+    }
+    for metric, dist_data in metrics.items():
+        for dist, alg_data in dist_data.items():
+            plt.figure()
+            for alg, points in alg_data.items():
+                ns = [p[0] for p in points]
+                values = [p[1] for p in points]
+                plt.plot(ns, values, marker='o', label=alg)
+            plt.xscale('log')
+            plt.xlabel('Размер массива n')
+            plt.ylabel(labels.get(metric, metric))
+            plt.title(f'{labels.get(metric, metric)}: {dist}')
+            plt.legend()
+            plt.grid(True)
+            filename = f'plot_{dist}_{metric}.png'.replace(' ', '_')
+            plt.savefig(os.path.join(output_dir, filename))
+            plt.close()
+            print(f'Plot saved to {filename}')
+
+
+def load_memory(csv_path):
+    """Load memory per key from a CSV file.
+
+    Returns a mapping of group -> algorithm -> list of (n, bytes_per_key).
+    Only rows that allocated memory are kept.
+    """
+    data = defaultdict(lambda: defaultdict(list))
+    with open(csv_path, newline='', encoding='utf-8') as f:
+        reader = csv.DictReader(f)
+        for row in reader:
+            per_key = _number(row, 'bytes_per_key')
+            if not per_key:
+                continue
+            data[_group(row)][row['algorithm']].append((int(row['n']), per_key))
+    for alg_data in data.values():
+        for points in alg_data.values():
+            points.sort(key=lambda x: x[0])
+    return data
+
+
+def plot_memory(data, output_dir):
+    """Plot memory per key for each group and save PNG files."""
+    for group, alg_data in data.items():
+        plt.figure()
+        for alg, points in alg_data.items():
+            ns = [p[0] for p in points]
+            values = [p[1] for p in points]
+            plt.plot(ns, values, marker='o', label=alg)
+        plt.xscale('log')
+        plt.xlabel('Количество ключей n')
+        plt.ylabel('Пиковая память, байт на ключ')
+        plt.title(f'Память на ключ: {group}')
+        plt.legend()
+        plt.grid(True)
+        filename = f'plot_{group}_memory.png'.replace(' ', '_')
+        plt.savefig(os.path.join(output_dir, filename))
+        plt.close()
+        print(f'Plot saved to {filename}')
+
+
+def plot_throughput(data, output_dir):
+    """Plot tree throughput for each workload/distribution group."""
+    for group, alg_data in data.items():
+        plt.figure()
+        for alg, points in alg_data.items():
+            ns = [p[0] for p in points]
+            mops = [p[1] for p in points]
+            plt.plot(ns, mops, marker='o', label=alg)
+        plt.xscale('log')
+        plt.xlabel('Количество ключей n')
+        plt.ylabel('Млн операций в секунду')
+        plt.title(f'Пропускная способность деревьев: {group}')
+        plt.legend()
+        plt.grid(True)
+        filename = f'plot_{group}_throughput.png'.replace(' ', '_')
+        plt.savefig(os.path.join(output_dir, filename))
+        plt.close()
+        print(f'Plot saved to {filename}')
+
+
+def load_scaling(csv_path):
+    """Load concurrent throughput from a CSV file.
+
+    Returns a mapping of group -> algorithm -> list of (threads, mops),
+    where the group also includes n.
+    """
+    data = defaultdict(lambda: defaultdict(list))
+    with open(csv_path, newline='', encoding='utf-8') as f:
+        reader = csv.DictReader(f)
+        for row in reader:
+            group = f"{_group(row)}_n{row['n']}"
+            data[group][row['algorithm']].append((int(row['threads']), float(row['mops'])))
+    for alg_data in data.values():
+        for points in alg_data.values():
+            points.sort(key=lambda x: x[0])
+    return data
+
+
+def plot_scaling(data, output_dir):
+    """Plot throughput versus number of threads for each group."""
+    for group, alg_data in data.items():
+        plt.figure()
+        for alg, points in alg_data.items():
+            threads = [p[0] for p in points]
+            mops = [p[1] for p in points]
+            plt.plot(threads, mops, marker='o', label=alg)
+        plt.xscale('log', base=2)
+        plt.xlabel('Число потоков')
+        plt.ylabel('Млн операций в секунду')
+        plt.title(f'Масштабирование по потокам: {group}')
+        plt.legend()
+        plt.grid(True)
+        filename = f'plot_{group}_scaling.png'.replace(' ', '_')
+        plt.savefig(os.path.join(output_dir, filename))
+        plt.close()
+        print(f'Plot saved to {filename}')
+
+
+def _header(csv_path):
+    with open(csv_path, newline='', encoding='utf-8') as f:
+        return next(csv.reader(f), [])
+
+
+def is_tree_results(csv_path):
+    """Return True if the file was written by tree_bench or concurrent_bench."""
+    return 'workload' in _header(csv_path)
+
+
+def is_concurrent_results(csv_path):
+    """Return True if the file was written by concurrent_bench."""
+    return 'threads' in _header(csv_path)
+
+
 def plot_distributions(data, output_dir):
     """Plot running times for each distribution and save PNG files."""
     for dist, alg_data in data.items():
@@ -68,17 +287,23 @@ def plot_distributions(data, output_dir):
 
 
 def main():
-    if len(sys.argv) > 2:
-        print("Usage: python visualize.py [results.csv]")
-        sys.exit(1)
-    csv_path = sys.argv[1] if len(sys.argv) == 2 else 'results.csv'
-    if not os.path.isfile(csv_path):
-        print(f'Error: {csv_path} does not exist')
-        sys.exit(1)
-    data = load_results(csv_path)
-    output_dir = os.path.join(os.path.dirname(os.path.abspath(csv_path)), 'plots')
-    os.makedirs(output_dir, exist_ok=True)
-    plot_distributions(data, output_dir)
+    csv_paths = sys.argv[1:] if len(sys.argv) > 1 else ['results.csv']
+    for csv_path in csv_paths:
+        if not os.path.isfile(csv_path):
+            print(f'Error: {csv_path} does not exist')
+            sys.exit(1)
+    for csv_path in csv_paths:
+        output_dir = os.path.join(os.path.dirname(os.path.abspath(csv_path)), 'plots')
+        os.makedirs(output_dir, exist_ok=True)
+        if is_concurrent_results(csv_path):
+            plot_scaling(load_scaling(csv_path), output_dir)
+            continue
+        if is_tree_results(csv_path):
+            plot_throughput(load_results(csv_path, 'mops'), output_dir)
+        else:
+            plot_distributions(load_results(csv_path), output_dir)
+        plot_counters(load_counters(csv_path), output_dir)
+        plot_memory(load_memory(csv_path), output_dir)
 
 
 if __name__ == '__main__':
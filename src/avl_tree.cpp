@@ -97,6 +97,60 @@ AVLNode* avlInsert(AVLNode* node, int key) {
     return node;
 }
 
+// Search for key without recursion
+bool avlContains(const AVLNode* root, int key) {
+    const AVLNode* node = root;
+    while (node) {
+        if (key < node->key)
+            node = node->left;
+        else if (key > node->key)
+            node = node->right;
+        else
+            return true;
+    }
+    return false;
+}
+
+// Batched search with interleaved lanes (asynchronous memory access
+// chaining): each lane holds one search; a finished lane immediately
+// takes the next key, so all lanes stay busy until the batch runs out
+void avlLookupBatch(const AVLNode* root, const int* keys, std::size_t n, bool* found) {
+    constexpr std::size_t kLanes = 16;
+    struct Lane {
+        const AVLNode* node; // node to visit next (already prefetched)
+        std::size_t index;   // position of the key in the batch
+    };
+    Lane lanes[kLanes];
+    std::size_t next = 0;
+    std::size_t active = 0;
+    while (active < kLanes && next < n) lanes[active++] = {root, next++};
+
+    while (active > 0) {
+        std::size_t l = 0;
+        while (l < active) {
+            Lane& lane = lanes[l];
+            const AVLNode* node = lane.node;
+            int key = keys[lane.index];
+            if (!node || node->key == key) {
+                found[lane.index] = node != nullptr;
+                if (next < n) {
+                    lane = {root, next++};
+                    ++l;
+                } else {
+                    // Batch exhausted: move the last lane here and shrink
+                    lane = lanes[--active];
+                }
+                continue;
+            }
+            lane.node = key < node->key ? node->left : node->right;
+#if defined(__GNUC__)
+            __builtin_prefetch(lane.node);
+#endif
+            ++l;
+        }
+    }
+}
+
 // Print an inorder traversal
 void inorder(AVLNode* root) {
     if (!root) return;
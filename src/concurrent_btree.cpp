@@ -0,0 +1,377 @@
+#include "../include/concurrent_btree.h"
+
+#include <climits>
+#include <thread>
+
+namespace {
+
+constexpr std::uint64_t kLockedBit = 2;
+
+// Back off while another thread holds a lock: spin briefly, then yield so
+// that a preempted lock holder can run
+void backoff(int& spins) {
+    if (++spins < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
+// Common header of leaves and inner nodes.  All fields that optimistic
+// readers look at are atomics accessed with relaxed ordering; the version
+// word provides the ordering (a seqlock).  Nodes are cache-line aligned
+// so that a 256-byte node occupies exactly four lines and its version word
+// never shares a line with another node.
+struct alignas(64) ConcurrentBTree::Node {
+    std::atomic<std::uint64_t> version{0};
+    std::atomic<int> count{0};
+    const bool isLeaf;
+
+    explicit Node(bool leaf) : isLeaf(leaf) {}
+
+    // Wait until the node is not locked and return its version
+    std::uint64_t readLock() const {
+        std::uint64_t v = version.load(std::memory_order_acquire);
+        int spins = 0;
+        while (v & kLockedBit) {
+            backoff(spins);
+            v = version.load(std::memory_order_acquire);
+        }
+        return v;
+    }
+
+    // True if nothing changed since readLock returned v, i.e. everything
+    // read from the node in between is consistent
+    bool validate(std::uint64_t v) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version.load(std::memory_order_relaxed) == v;
+    }
+
+    // Turn an optimistic read into an exclusive lock; fails if the node
+    // changed since v was read
+    bool tryUpgrade(std::uint64_t v) {
+        if (!version.compare_exchange_strong(v, v + kLockedBit, std::memory_order_acquire)) {
+            return false;
+        }
+        // Readers that see any of the following writes must also see the lock bit
+        std::atomic_thread_fence(std::memory_order_release);
+        return true;
+    }
+
+    // Clear the lock bit and bump the version in one step
+    void writeUnlock() { version.fetch_add(kLockedBit, std::memory_order_release); }
+
+    int size() const {
+        int n = count.load(std::memory_order_relaxed);
+        return n < 0 ? 0 : n;
+    }
+};
+
+struct ConcurrentBTree::Leaf : Node {
+    std::atomic<int> keys[kLeafCapacity];
+
+    Leaf() : Node(true) {
+        for (auto& k : keys) k.store(0, std::memory_order_relaxed);
+    }
+
+    // Position of the first key that is not less than key
+    int lowerBound(int key) const {
+        int lo = 0;
+        int hi = size() < kLeafCapacity ? size() : kLeafCapacity;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (keys[mid].load(std::memory_order_relaxed) < key)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    // Insert into a locked, non-full leaf; false if the key is present
+    bool insert(int key) {
+        int n = size();
+        int pos = lowerBound(key);
+        if (pos < n && keys[pos].load(std::memory_order_relaxed) == key) return false;
+        for (int i = n; i > pos; --i) {
+            keys[i].store(keys[i - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        keys[pos].store(key, std::memory_order_relaxed);
+        count.store(n + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Split a locked leaf: the upper half moves to a new leaf, sep receives
+    // the largest key that stays here
+    Leaf* split(int& sep) {
+        Leaf* right = new Leaf();
+        int n = size();
+        int half = n / 2;
+        for (int i = half; i < n; ++i) {
+            right->keys[i - half].store(keys[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        right->count.store(n - half, std::memory_order_relaxed);
+        count.store(half, std::memory_order_relaxed);
+        sep = keys[half - 1].load(std::memory_order_relaxed);
+        return right;
+    }
+};
+
+// Inner node: keys[i] is the largest key of children[i]'s subtree, and
+// every key of children[i + 1] is greater than keys[i]
+struct ConcurrentBTree::Inner : Node {
+    std::atomic<int> keys[kInnerCapacity];
+    std::atomic<Node*> children[kInnerCapacity + 1];
+
+    Inner() : Node(false) {
+        for (auto& k : keys) k.store(0, std::memory_order_relaxed);
+        for (auto& c : children) c.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // Index of the child whose subtree may contain key
+    int lowerBound(int key) const {
+        int lo = 0;
+        int hi = size() < kInnerCapacity ? size() : kInnerCapacity;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (keys[mid].load(std::memory_order_relaxed) < key)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    // Insert a separator and the child to its right into a locked,
+    // non-full node
+    void insertChild(int sep, Node* right) {
+        int n = size();
+        int pos = lowerBound(sep);
+        for (int i = n; i > pos; --i) {
+            keys[i].store(keys[i - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            children[i + 1].store(children[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        keys[pos].store(sep, std::memory_order_relaxed);
+        children[pos + 1].store(right, std::memory_order_relaxed);
+        count.store(n + 1, std::memory_order_relaxed);
+    }
+
+    // Split a locked node: the middle key moves up through sep, the keys
+    // and children above it move to a new node
+    Inner* split(int& sep) {
+        Inner* right = new Inner();
+        int n = size();
+        int mid = n / 2;
+        for (int i = mid + 1; i < n; ++i) {
+            right->keys[i - mid - 1].store(keys[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        for (int i = mid + 1; i <= n; ++i) {
+            right->children[i - mid - 1].store(children[i].load(std::memory_order_relaxed),
+                                               std::memory_order_relaxed);
+        }
+        right->count.store(n - mid - 1, std::memory_order_relaxed);
+        sep = keys[mid].load(std::memory_order_relaxed);
+        count.store(mid, std::memory_order_relaxed);
+        return right;
+    }
+};
+
+ConcurrentBTree::ConcurrentBTree() : root_(new Leaf()) {
+    static_assert(sizeof(Leaf) % 64 == 0 && sizeof(Inner) % 64 == 0, "nodes must fill whole cache lines");
+}
+
+ConcurrentBTree::~ConcurrentBTree() {
+    // Nodes are only reachable from the root; walk them iteratively
+    std::vector<Node*> stack{root_.load(std::memory_order_relaxed)};
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        if (node->isLeaf) {
+            delete static_cast<Leaf*>(node);
+        } else {
+            Inner* inner = static_cast<Inner*>(node);
+            for (int i = 0; i <= inner->size(); ++i) {
+                stack.push_back(inner->children[i].load(std::memory_order_relaxed));
+            }
+            delete inner;
+        }
+    }
+}
+
+bool ConcurrentBTree::insert(int key) {
+    for (;;) {
+        Node* node = root_.load(std::memory_order_acquire);
+        std::uint64_t v = node->readLock();
+        if (node != root_.load(std::memory_order_acquire)) continue;
+
+        Inner* parent = nullptr;
+        std::uint64_t vParent = 0;
+        bool restart = false;
+
+        // Lock the node (and its parent) and split it.  Afterwards the
+        // descent restarts from the root.
+        auto splitNode = [&](Node* full, std::uint64_t vFull) {
+            if (parent && !parent->tryUpgrade(vParent)) return;
+            if (!full->tryUpgrade(vFull)) {
+                if (parent) parent->writeUnlock();
+                return;
+            }
+            if (!parent && full != root_.load(std::memory_order_relaxed)) {
+                // Another thread grew the tree above this node
+                full->writeUnlock();
+                return;
+            }
+            int sep = 0;
+            Node* right = full->isLeaf ? static_cast<Node*>(static_cast<Leaf*>(full)->split(sep))
+                                       : static_cast<Node*>(static_cast<Inner*>(full)->split(sep));
+            if (parent) {
+                parent->insertChild(sep, right);
+            } else {
+                Inner* newRoot = new Inner();
+                newRoot->keys[0].store(sep, std::memory_order_relaxed);
+                newRoot->children[0].store(full, std::memory_order_relaxed);
+                newRoot->children[1].store(right, std::memory_order_relaxed);
+                newRoot->count.store(1, std::memory_order_relaxed);
+                root_.store(newRoot, std::memory_order_release);
+            }
+            full->writeUnlock();
+            if (parent) parent->writeUnlock();
+        };
+
+        while (!node->isLeaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            // Split full nodes on the way down so that a split below never
+            // has to propagate further than one level up
+            if (inner->size() == kInnerCapacity) {
+                splitNode(inner, v);
+                restart = true;
+                break;
+            }
+            if (parent && !parent->validate(vParent)) {
+                restart = true;
+                break;
+            }
+            parent = inner;
+            vParent = v;
+            node = inner->children[inner->lowerBound(key)].load(std::memory_order_relaxed);
+            // The child pointer may only be followed if it was read consistently
+            if (!inner->validate(v)) {
+                restart = true;
+                break;
+            }
+            v = node->readLock();
+        }
+        if (restart) continue;
+
+        Leaf* leaf = static_cast<Leaf*>(node);
+        if (leaf->size() == kLeafCapacity) {
+            splitNode(leaf, v);
+            continue;
+        }
+        if (!leaf->tryUpgrade(v)) continue;
+        if (parent && !parent->validate(vParent)) {
+            leaf->writeUnlock();
+            continue;
+        }
+        bool inserted = leaf->insert(key);
+        leaf->writeUnlock();
+        return inserted;
+    }
+}
+
+bool ConcurrentBTree::contains(int key) const {
+    for (;;) {
+        const Node* node = root_.load(std::memory_order_acquire);
+        std::uint64_t v = node->readLock();
+        if (node != root_.load(std::memory_order_acquire)) continue;
+
+        bool restart = false;
+        while (!node->isLeaf) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            const Node* child = inner->children[inner->lowerBound(key)].load(std::memory_order_relaxed);
+            if (!inner->validate(v)) {
+                restart = true;
+                break;
+            }
+            std::uint64_t vChild = child->readLock();
+            // If the child was split before its version was read, the key may
+            // have moved to a sibling; the split also changed this node
+            if (!inner->validate(v)) {
+                restart = true;
+                break;
+            }
+            node = child;
+            v = vChild;
+        }
+        if (restart) continue;
+
+        const Leaf* leaf = static_cast<const Leaf*>(node);
+        int pos = leaf->lowerBound(key);
+        bool found = pos < leaf->size() && leaf->keys[pos].load(std::memory_order_relaxed) == key;
+        if (!leaf->validate(v)) continue;
+        return found;
+    }
+}
+
+void ConcurrentBTree::collect(std::vector<int>& out) const {
+    std::vector<const Node*> stack{root_.load(std::memory_order_acquire)};
+    // Push children right to left so that the leftmost subtree is visited first
+    while (!stack.empty()) {
+        const Node* node = stack.back();
+        stack.pop_back();
+        if (node->isLeaf) {
+            const Leaf* leaf = static_cast<const Leaf*>(node);
+            for (int i = 0; i < leaf->size(); ++i) out.push_back(leaf->keys[i].load(std::memory_order_relaxed));
+        } else {
+            const Inner* inner = static_cast<const Inner*>(node);
+            for (int i = inner->size(); i >= 0; --i) {
+                stack.push_back(inner->children[i].load(std::memory_order_relaxed));
+            }
+        }
+    }
+}
+
+bool ConcurrentBTree::verify() const {
+    // Every key of a subtree must lie in (low, high]; all leaves at one depth
+    struct Frame {
+        const Node* node;
+        long long low;
+        long long high;
+        int depth;
+    };
+    std::vector<Frame> stack{{root_.load(std::memory_order_acquire), LLONG_MIN, LLONG_MAX, 0}};
+    int leafDepth = -1;
+    while (!stack.empty()) {
+        Frame f = stack.back();
+        stack.pop_back();
+        if (!f.node || (f.node->version.load(std::memory_order_relaxed) & kLockedBit)) return false;
+        if (f.node->isLeaf) {
+            const Leaf* leaf = static_cast<const Leaf*>(f.node);
+            if (leafDepth < 0) leafDepth = f.depth;
+            if (f.depth != leafDepth || leaf->size() > kLeafCapacity) return false;
+            long long prev = f.low;
+            for (int i = 0; i < leaf->size(); ++i) {
+                long long k = leaf->keys[i].load(std::memory_order_relaxed);
+                if (k <= prev || k > f.high) return false;
+                prev = k;
+            }
+        } else {
+            const Inner* inner = static_cast<const Inner*>(f.node);
+            int n = inner->size();
+            if (n < 1 || n > kInnerCapacity) return false;
+            long long prev = f.low;
+            for (int i = 0; i < n; ++i) {
+                long long k = inner->keys[i].load(std::memory_order_relaxed);
+                if (k <= prev || k > f.high) return false;
+                stack.push_back({inner->children[i].load(std::memory_order_relaxed), prev, k, f.depth + 1});
+                prev = k;
+            }
+            stack.push_back({inner->children[n].load(std::memory_order_relaxed), prev, f.high, f.depth + 1});
+        }
+    }
+    return true;
+}
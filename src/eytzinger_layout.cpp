@@ -0,0 +1,118 @@
+#include "../include/eytzinger_layout.h"
+
+// Fill keys[k..] in Eytzinger order: an inorder walk of the implicit tree
+// (children 2k and 2k + 1) visits the slots in ascending key order, so the
+// slots simply take the next key from the sorted source.
+template <class Next>
+static void fill(int* keys, std::size_t n, std::size_t k, Next& next) {
+    if (k > n) return;
+    fill(keys, n, 2 * k, next);
+    keys[k] = next();
+    fill(keys, n, 2 * k + 1, next);
+}
+
+template <class Next>
+static EytzingerLayout buildFrom(std::size_t n, Next& next) {
+    EytzingerLayout layout;
+    if (n == 0) return layout;
+    layout.keys.assign(n + 1, 0);
+    fill(layout.keys.data(), n, 1, next);
+    return layout;
+}
+
+EytzingerLayout buildEytzinger(const std::vector<int>& sortedKeys) {
+    std::size_t i = 0;
+    auto next = [&] { return sortedKeys[i++]; };
+    return buildFrom(sortedKeys.size(), next);
+}
+
+static std::size_t countAVL(const AVLNode* node) {
+    if (!node) return 0;
+    return 1 + countAVL(node->left) + countAVL(node->right);
+}
+
+EytzingerLayout freezeAVL(const AVLNode* root) {
+    // Iterative inorder walk; the stack never holds more than height(root) nodes
+    std::vector<const AVLNode*> stack;
+    const AVLNode* node = root;
+    auto next = [&] {
+        while (node) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        const AVLNode* top = stack.back();
+        stack.pop_back();
+        node = top->right;
+        return top->key;
+    };
+    return buildFrom(countAVL(root), next);
+}
+
+static std::size_t count23(const Node23* node) {
+    if (!node) return 0;
+    std::size_t n = node->keys.size();
+    for (const Node23* child : node->children) n += count23(child);
+    return n;
+}
+
+EytzingerLayout freeze23(const Node23* root) {
+    // Iterative inorder walk: each frame remembers the next key to emit
+    struct Frame {
+        const Node23* node;
+        std::size_t i;
+    };
+    std::vector<Frame> stack;
+    auto descend = [&](const Node23* node) {
+        while (node) {
+            stack.push_back({node, 0});
+            node = node->isLeaf() ? nullptr : node->children[0];
+        }
+    };
+    descend(root);
+    auto next = [&] {
+        Frame& top = stack.back();
+        const Node23* node = top.node;
+        int key = node->keys[top.i++];
+        // Keys are emitted between children: after key i comes subtree i + 1
+        const Node23* child = node->isLeaf() ? nullptr : node->children[top.i];
+        if (top.i == node->keys.size()) stack.pop_back();
+        descend(child);
+        return key;
+    };
+    return buildFrom(count23(root), next);
+}
+
+// Return the index of the smallest key >= key, or 0 if there is none
+static std::size_t lowerBoundIndex(const EytzingerLayout& layout, int key) {
+    const int* keys = layout.keys.data();
+    std::size_t n = layout.size();
+    std::size_t k = 1;
+    while (k <= n) {
+#if defined(__GNUC__)
+        // 16 descendants four levels down share one cache line
+        __builtin_prefetch(keys + k * 16);
+#endif
+        k = 2 * k + static_cast<std::size_t>(keys[k] < key);
+    }
+    // The path ended with some right turns (ones) after the last left turn
+    // (a zero) at the answer; drop them together with that zero.
+#if defined(__GNUC__)
+    k >>= __builtin_ctzll(~static_cast<unsigned long long>(k)) + 1;
+#else
+    while (k & 1) k >>= 1;
+    k >>= 1;
+#endif
+    return k;
+}
+
+bool eytzingerContains(const EytzingerLayout& layout, int key) {
+    std::size_t k = lowerBoundIndex(layout, key);
+    return k != 0 && layout.keys[k] == key;
+}
+
+bool eytzingerLowerBound(const EytzingerLayout& layout, int key, int& result) {
+    std::size_t k = lowerBoundIndex(layout, key);
+    if (k == 0) return false;
+    result = layout.keys[k];
+    return true;
+}
@@ -1,7 +1,6 @@
 #include <iostream>
 #include <vector>
-#include <fstream>
-#include <chrono>
+#include <cstdlib>
 #include <random>
 #include <iomanip>
 #include <algorithm>
@@ -28,23 +27,20 @@ static std::vector<int> generateDistinct(std::size_t n, std::mt19937& gen) {
     return v;
 }
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "Лабораторная работа 11 (ч.2)\n";
     std::cout << "---------------------------------\n\n";
 
     // -----------------------------
     // Пункт 6: AVL-дерево
     // -----------------------------
-    std::mt19937 gen(static_cast<unsigned int>(
-        std::chrono::steady_clock::now().time_since_epoch().count()));
+    // Фиксированное зерно: при одинаковом n всегда строятся одинаковые деревья
+    std::mt19937 gen(42);
 
     std::size_t n_tree = 15;
-    std::cout << "Введите n (кол-во различных чисел) для построения AVL и 2-3 дерева (по умолчанию 15): ";
-    std::size_t tmp = 0;
-    if (std::cin >> tmp && tmp > 0) n_tree = tmp;
-    else {
-        std::cin.clear();
-        std::cin.ignore(10000, '\n');
+    if (argc > 1) {
+        long long tmp = std::atoll(argv[1]);
+        if (tmp > 0) n_tree = static_cast<std::size_t>(tmp);
     }
 
     std::vector<int> treeValues = generateDistinct(n_tree, gen);
@@ -93,70 +89,11 @@ int main() {
     heapSortCharWithSteps(listC);
 
     // -----------------------------
-    // Пункт 9: три сортировки и исследование производительности
+    // Пункт 9: исследование производительности сортировок
     // -----------------------------
-    std::cout << "\n[Пункт 9] Исследование производительности сортировок.\n";
-    std::cout << "Размеры: 10^2, 10^3, 10^4, 10^5, 10^6\n";
-    std::cout << "Типы входных данных: случайные [1..n], возрастающие, убывающие\n";
-    std::cout << "Алгоритмы: merge, quick, heap\n\n";
-
-    std::vector<std::size_t> sizes = {100, 1000, 10000, 100000, 1000000};
-    std::vector<std::string> distributions = {"random", "ascending", "descending"};
-    std::vector<std::string> algorithms = {"merge", "quick", "heap"};
-
-    std::ofstream fout("results.csv");
-    if (!fout) {
-        std::cerr << "Ошибка: не удалось открыть results.csv для записи.\n";
-        return 1;
-    }
-    fout << "algorithm,n,distribution,time_ms\n";
-
-    for (const auto& alg : algorithms) {
-        for (std::size_t n : sizes) {
-            for (const auto& dist : distributions) {
-                // Генерация входного массива
-                std::vector<int> arr;
-                arr.reserve(n);
-
-                if (dist == "random") {
-                    std::uniform_int_distribution<> dis(1, static_cast<int>(n));
-                    for (std::size_t i = 0; i < n; ++i) {
-                        arr.push_back(dis(gen));
-                    }
-                } else if (dist == "ascending") {
-                    for (std::size_t i = 0; i < n; ++i) arr.push_back(static_cast<int>(i + 1));
-                } else { // descending
-                    for (std::size_t i = 0; i < n; ++i) arr.push_back(static_cast<int>(n - i));
-                }
-
-                std::vector<int> toSort = arr;
-
-                auto start = std::chrono::steady_clock::now();
-                if (alg == "merge") {
-                    mergeSort(toSort, 0, toSort.size() - 1);
-                } else if (alg == "quick") {
-                    quickSort(toSort, 0, toSort.size() - 1);
-                } else {
-                    heapSort(toSort);
-                }
-                auto end = std::chrono::steady_clock::now();
-
-                double elapsed_ms =
-                    std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
-
-                fout << alg << "," << n << "," << dist << ","
-                     << std::fixed << std::setprecision(3) << elapsed_ms << "\n";
-                fout.flush();
-
-                std::cout << "Готово: " << alg << ", n=" << n
-                          << ", тип=" << dist
-                          << ", время=" << elapsed_ms << " мс\n";
-            }
-        }
-    }
-    fout.close();
-    std::cout << "\nРезультаты записаны в файл results.csv\n";
-    std::cout << "Для графиков запусти: python3 scripts/visualize.py results.csv\n";
+    std::cout << "\n[Пункт 9] Исследование производительности сортировок вынесено в отдельную программу.\n";
+    std::cout << "Запусти: ./build/sort_bench (параметры: ./build/sort_bench --help)\n";
+    std::cout << "Для графиков: python3 scripts/visualize.py results.csv\n\n";
 
     // -----------------------------
     // Пункт 5: обратная подстановка Гаусса + Θ(n^2)
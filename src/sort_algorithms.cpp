@@ -44,22 +44,31 @@ void mergeSort(std::vector<int>& arr, std::size_t l, std::size_t r) {
     mergeSortRec(arr, temp, l, r);
 }
 
-// Internal quick sort using long long indices to avoid size_t underflow
+// Internal quick sort using long long indices to avoid size_t underflow.
+// Recurses into the smaller part and loops on the larger one, so the
+// stack depth stays O(log n) even when the pivot choice is poor.
 static void quickSortInternal(std::vector<int>& arr, long long left, long long right) {
-    long long i = left;
-    long long j = right;
-    int pivot = arr[left + (right - left) / 2];
-    while (i <= j) {
-        while (arr[i] < pivot) ++i;
-        while (arr[j] > pivot) --j;
-        if (i <= j) {
-            std::swap(arr[i], arr[j]);
-            ++i;
-            --j;
+    while (left < right) {
+        long long i = left;
+        long long j = right;
+        int pivot = arr[left + (right - left) / 2];
+        while (i <= j) {
+            while (arr[i] < pivot) ++i;
+            while (arr[j] > pivot) --j;
+            if (i <= j) {
+                std::swap(arr[i], arr[j]);
+                ++i;
+                --j;
+            }
+        }
+        if (j - left < right - i) {
+            if (left < j) quickSortInternal(arr, left, j);
+            left = i;
+        } else {
+            if (i < right) quickSortInternal(arr, i, right);
+            right = j;
         }
     }
-    if (left < j) quickSortInternal(arr, left, j);
-    if (i < right) quickSortInternal(arr, i, right);
 }
 
 void quickSort(std::vector<int>& arr, std::size_t l, std::size_t r) {
@@ -67,6 +76,79 @@ void quickSort(std::vector<int>& arr, std::size_t l, std::size_t r) {
     quickSortInternal(arr, static_cast<long long>(l), static_cast<long long>(r));
 }
 
+// Index of the median of arr[a], arr[b], arr[c]
+static long long medianOfThree(const std::vector<int>& arr, long long a, long long b, long long c) {
+    if (arr[a] < arr[b]) {
+        if (arr[b] < arr[c]) return b;
+        return arr[a] < arr[c] ? c : a;
+    }
+    if (arr[a] < arr[c]) return a;
+    return arr[b] < arr[c] ? c : b;
+}
+
+// Insertion sort of arr[left..right]; used for small subarrays
+static void insertionSort(std::vector<int>& arr, long long left, long long right) {
+    for (long long i = left + 1; i <= right; ++i) {
+        int v = arr[i];
+        long long j = i - 1;
+        while (j >= left && arr[j] > v) {
+            arr[j + 1] = arr[j];
+            --j;
+        }
+        arr[j + 1] = v;
+    }
+}
+
+// Three-way quick sort: partitions arr[left..right] into < pivot, == pivot
+// and > pivot (Dijkstra's Dutch national flag) so equal keys are never
+// touched again.  The pivot is the median of three for small ranges and
+// Tukey's ninther for larger ones, as in Bentley and McIlroy's qsort.
+static void quickSort3WayInternal(std::vector<int>& arr, long long left, long long right) {
+    while (right - left >= 16) {
+        long long n = right - left + 1;
+        long long mid = left + n / 2;
+        long long m;
+        if (n > 40) {
+            long long s = n / 8;
+            m = medianOfThree(arr, medianOfThree(arr, left, left + s, left + 2 * s),
+                              medianOfThree(arr, mid - s, mid, mid + s),
+                              medianOfThree(arr, right - 2 * s, right - s, right));
+        } else {
+            m = medianOfThree(arr, left, mid, right);
+        }
+        int pivot = arr[m];
+
+        // Invariant: arr[left..lt-1] < pivot, arr[lt..i-1] == pivot, arr[gt+1..right] > pivot
+        long long lt = left;
+        long long i = left;
+        long long gt = right;
+        while (i <= gt) {
+            if (arr[i] < pivot) {
+                std::swap(arr[lt++], arr[i++]);
+            } else if (arr[i] > pivot) {
+                std::swap(arr[i], arr[gt--]);
+            } else {
+                ++i;
+            }
+        }
+
+        // Recurse into the smaller side to keep the stack depth O(log n)
+        if (lt - left < right - gt) {
+            quickSort3WayInternal(arr, left, lt - 1);
+            left = gt + 1;
+        } else {
+            quickSort3WayInternal(arr, gt + 1, right);
+            right = lt - 1;
+        }
+    }
+    insertionSort(arr, left, right);
+}
+
+void quickSort3Way(std::vector<int>& arr, std::size_t l, std::size_t r) {
+    if (arr.empty() || l >= r) return;
+    quickSort3WayInternal(arr, static_cast<long long>(l), static_cast<long long>(r));
+}
+
 // Heapify a subtree rooted at index i
 static void heapify(std::vector<int>& arr, std::size_t n, std::size_t i) {
     std::size_t largest = i;
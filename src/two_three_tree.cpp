@@ -7,21 +7,28 @@ struct InsertResult {
     bool hasPromoted;      ///< whether a key was promoted to the parent
     int promotedKey;       ///< the key that moved up to the parent
     Node23* rightChild;    ///< the right child created after a split
-    InsertResult() : hasPromoted(false), promotedKey(0), rightChild(nullptr) {}
+    bool inserted;         ///< false if the key was already present
+    InsertResult() : hasPromoted(false), promotedKey(0), rightChild(nullptr), inserted(false) {}
 };
 
 /**
  * Recursively insert a key into the subtree rooted at node.  Returns a
  * structure describing whether a split occurred.  This helper performs
  * post‑order splitting: it only splits when a node actually overflows
- * after insertion.
+ * after insertion.  A key that is already present leaves the tree
+ * unchanged.
  */
 static InsertResult insertInternal(Node23* node, int key) {
     InsertResult res;
+    // Duplicate keys are not inserted
+    if (std::find(node->keys.begin(), node->keys.end(), key) != node->keys.end()) {
+        return res;
+    }
     // If this node is a leaf, insert the key here
     if (node->isLeaf()) {
         // Insert the key in sorted order
         node->keys.insert(std::upper_bound(node->keys.begin(), node->keys.end(), key), key);
+        res.inserted = true;
         // If the node now has three keys, we need to split
         if (node->keys.size() == 3) {
             // keys are sorted; median is at index 1
@@ -50,6 +57,7 @@ static InsertResult insertInternal(Node23* node, int key) {
     }
     // Recurse into the chosen child
     InsertResult childRes = insertInternal(node->children[i], key);
+    res.inserted = childRes.inserted;
     if (childRes.hasPromoted) {
         // Insert promoted key into this node
         node->keys.insert(node->keys.begin() + i, childRes.promotedKey);
@@ -80,11 +88,11 @@ static InsertResult insertInternal(Node23* node, int key) {
     return res;
 }
 
-void insert23(Node23*& root, int key) {
+bool insert23(Node23*& root, int key) {
     if (!root) {
         root = new Node23();
         root->keys.push_back(key);
-        return;
+        return true;
     }
     InsertResult res = insertInternal(root, key);
     // If the root split, create a new root
@@ -95,6 +103,83 @@ void insert23(Node23*& root, int key) {
         newRoot->children.push_back(res.rightChild);
         root = newRoot;
     }
+    return res.inserted;
+}
+
+// Search for key, descending one level per iteration
+bool contains23(const Node23* node, int key) {
+    while (node) {
+        // Find the first key that is not less than the search key
+        size_t i = 0;
+        while (i < node->keys.size() && node->keys[i] < key) ++i;
+        if (i < node->keys.size() && node->keys[i] == key) return true;
+        if (node->isLeaf()) return false;
+        node = node->children[i];
+    }
+    return false;
+}
+
+// Batched search; a state machine per lane (see the header for the stages)
+void lookupBatch23(const Node23* root, const int* keys, std::size_t n, bool* found) {
+    constexpr std::size_t kLanes = 16;
+    struct Lane {
+        const Node23* node; // node being visited
+        std::size_t index;  // position of the key in the batch
+        bool loaded;        // true once the node's key/child buffers were prefetched
+    };
+    Lane lanes[kLanes];
+    std::size_t next = 0;
+    std::size_t active = 0;
+    while (active < kLanes && next < n) lanes[active++] = {root, next++, false};
+
+    while (active > 0) {
+        std::size_t l = 0;
+        while (l < active) {
+            Lane& lane = lanes[l];
+            const Node23* node = lane.node;
+            bool done = false;
+            bool hit = false;
+            if (!node) {
+                done = true;
+            } else if (!lane.loaded) {
+                // Stage 1: the node itself is in cache, fetch its buffers
+#if defined(__GNUC__)
+                __builtin_prefetch(node->keys.data());
+                if (!node->isLeaf()) __builtin_prefetch(node->children.data());
+#endif
+                lane.loaded = true;
+            } else {
+                // Stage 2: compare keys and move to the child
+                int key = keys[lane.index];
+                size_t i = 0;
+                while (i < node->keys.size() && node->keys[i] < key) ++i;
+                if (i < node->keys.size() && node->keys[i] == key) {
+                    done = true;
+                    hit = true;
+                } else if (node->isLeaf()) {
+                    done = true;
+                } else {
+                    lane.node = node->children[i];
+                    lane.loaded = false;
+#if defined(__GNUC__)
+                    __builtin_prefetch(lane.node);
+#endif
+                }
+            }
+
+            if (done) {
+                found[lane.index] = hit;
+                if (next < n) {
+                    lane = {root, next++, false};
+                    ++l;
+                } else {
+                    lane = lanes[--active];
+                }
+                continue;
+            }
+            ++l;
+        }
+    }
 }
 
 // Inorder traversal of 2–3 tree